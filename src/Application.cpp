@@ -1,6 +1,9 @@
 #include "Application.hpp"
 #include "Renderer.hpp"
 #include "Components.hpp"
+#include "FramePacer.hpp"
+#include "InputJournal.hpp"
+#include "MemoryTelemetry.hpp"
 #include "World.hpp"
 
 #include <GLFW/glfw3.h>
@@ -8,11 +11,18 @@
 #include "b2_user_settings.h"
 #include <box2d/box2d.h>
 
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
 SApplication g_application = {};
 
 int32_t g_velocityIterations = 6;
 int32_t g_positionIterations = 2;
 
+// seconds between two memory telemetry dumps, so long sessions leave data behind even if they crash
+constexpr double g_memoryTelemetryDumpInterval = 10.0;
+
 auto static OnCursorPositionCallback(
     [[maybe_unused]] GLFWwindow* window,
     double currentCursorX,
@@ -25,7 +35,14 @@ auto static OnCursorEnterCallback(
     [[maybe_unused]] GLFWwindow* window,
     int32_t entered) -> void {
 
-    g_application.IsWindowFocused = entered == 1;
+    g_application.IsCursorInsideWindow = entered == GLFW_TRUE;
+}
+
+auto static OnWindowFocusCallback(
+    [[maybe_unused]] GLFWwindow* window,
+    int32_t focused) -> void {
+
+    g_application.IsWindowFocused = focused == GLFW_TRUE;
 }
 
 auto static OnFramebufferResizeCallback(
@@ -70,6 +87,7 @@ auto InitializeApplication(const SApplicationConfiguration& applicationConfigura
         primaryMonitorResolution->width,
         primaryMonitorResolution->height
     };
+    g_application.Context.ScreenRefreshRate = primaryMonitorResolution->refreshRate;
     if (g_application.Configuration.WindowStyle != EWindowStyle::Windowed) {
         g_application.Context.WindowSize = g_application.Context.ScreenSize;
     } else {
@@ -120,6 +138,7 @@ auto InitializeApplication(const SApplicationConfiguration& applicationConfigura
 
     glfwSetCursorPosCallback(g_application.Window, OnCursorPositionCallback);
     glfwSetCursorEnterCallback(g_application.Window, OnCursorEnterCallback);
+    glfwSetWindowFocusCallback(g_application.Window, OnWindowFocusCallback);
     glfwSetFramebufferSizeCallback(g_application.Window, OnFramebufferResizeCallback);
 
     return true;
@@ -141,31 +160,58 @@ auto HandleResize() -> void {
     }
 
     if (g_application.Context.IsFramebufferResized) {
+        ResizeRenderer(g_application.Context.FramebufferSize);
+        g_application.Context.IsFramebufferResized = false;
+    }
+}
 
+auto SampleInputButtons() -> uint8_t {
+
+    auto isKeyDown = [](int32_t key) {
+        auto keyState = glfwGetKey(g_application.Window, key);
+        return keyState == GLFW_PRESS || keyState == GLFW_REPEAT;
+    };
+
+    uint8_t inputButtons = 0;
+    if (isKeyDown(GLFW_KEY_W)) {
+        inputButtons |= EInputButton::MoveUp;
+    }
+    if (isKeyDown(GLFW_KEY_S)) {
+        inputButtons |= EInputButton::MoveDown;
     }
+    if (isKeyDown(GLFW_KEY_A)) {
+        inputButtons |= EInputButton::MoveLeft;
+    }
+    if (isKeyDown(GLFW_KEY_D)) {
+        inputButtons |= EInputButton::MoveRight;
+    }
+
+    return inputButtons;
 }
 
-auto HandleInput(b2Body* playerBody) -> void {
+auto ApplyInput(uint8_t inputButtons) -> void {
+
+    // the player can be despawned through the world command buffer
+    if (g_world.PlayerEntity == entt::null) {
+        return;
+    }
+
+    auto playerBody = g_world.EntityRegistry.get<SPhysicsComponent>(g_world.PlayerEntity).Body;
 
     const float playerSpeed = 5.0f;
 
     b2Vec2 velocity = b2Vec2_zero;
 
-    auto keyW = glfwGetKey(g_application.Window, GLFW_KEY_W);
-    auto keyS = glfwGetKey(g_application.Window, GLFW_KEY_S);
-    auto keyA = glfwGetKey(g_application.Window, GLFW_KEY_A);
-    auto keyD = glfwGetKey(g_application.Window, GLFW_KEY_D);
-    
-    if (keyW == GLFW_PRESS || keyW == GLFW_REPEAT) {
+    if (inputButtons & EInputButton::MoveUp) {
         velocity.y -= playerSpeed;
     }
-    if (keyS == GLFW_PRESS || keyS == GLFW_REPEAT) {
+    if (inputButtons & EInputButton::MoveDown) {
         velocity.y += playerSpeed;
     }
-    if (keyA == GLFW_PRESS || keyA == GLFW_REPEAT) {
+    if (inputButtons & EInputButton::MoveLeft) {
         velocity.x -= playerSpeed;
     }
-    if (keyD == GLFW_PRESS || keyD == GLFW_REPEAT) {
+    if (inputButtons & EInputButton::MoveRight) {
         velocity.x += playerSpeed;
     }
 
@@ -176,17 +222,29 @@ auto HandleInput(b2Body* playerBody) -> void {
     }
 }
 
-auto UpdateWorld(entt::registry& registry, b2World& physicsWorld, float physicsDeltaTime) -> void {
+auto UpdateWorld(TEntityRegistry& registry, b2World& physicsWorld, float physicsDeltaTime) -> void {
 
     physicsWorld.Step(physicsDeltaTime, g_velocityIterations, g_positionIterations);
 
     auto playerView = registry.view<SPhysicsComponent, SPlayerComponent, SPositionComponent>();
-    const auto [playerPhysicsComponent, playerComponent, playerPositionComponent] = playerView.get(playerView.front());
+    auto playerEntity = playerView.front();
+    if (playerEntity == entt::null) {
+        // nothing to chase, commands still have to go through
+        FlushWorldCommands();
+        return;
+    }
+
+    const auto [playerPhysicsComponent, playerComponent, playerPositionComponent] = playerView.get(playerEntity);
     playerPositionComponent.Position = playerPhysicsComponent.Body->GetPosition();
 
     auto enemyView = registry.view<SPhysicsComponent, SEnemyComponent, SPositionComponent>();
     enemyView.each([&](auto& enemyPhysicsComponent, auto& enemyComponent, auto& enemyPositionComponent) {
 
+        // parked in a chunk outside the activation radius
+        if (!enemyPhysicsComponent.Body->IsEnabled()) {
+            return;
+        }
+
         b2Vec2 playerPosition = playerPhysicsComponent.Body->GetPosition();
         b2Vec2 enemyPosition = enemyPhysicsComponent.Body->GetPosition();
         b2Vec2 playerEnemyDirection = playerPosition - enemyPosition;
@@ -208,15 +266,43 @@ auto UpdateWorld(entt::registry& registry, b2World& physicsWorld, float physicsD
 */
         enemyPositionComponent.Position = enemyPosition;
     });
+
+    // spawns and despawns requested during this tick land here, outside of the step and all views
+    FlushWorldCommands();
+
+    // the flush can despawn the player and move component storage, don't use the references from above
+    if (g_world.PlayerEntity != entt::null) {
+        UpdateWorldChunks(registry.get<SPhysicsComponent>(g_world.PlayerEntity).Body->GetPosition());
+    }
 }
 
 auto RunApplication() -> void {
 
-    auto lastPhysicsUpdateTime = 0.0f;
     auto currentTime = glfwGetTime();
-    auto accumulator = 0.0f;
     auto physicsDeltaTime = 1.0f / 60.0f;
 
+    // with vsync the swap already paces frames, the limiter only takes over in the background
+    auto framePacer = CreateFramePacer({
+        .FixedDeltaTime = physicsDeltaTime,
+        .MaxStepsPerFrame = g_application.Configuration.MaxStepsPerFrame,
+        .FrameRateLimit = g_application.Configuration.IsVSyncEnabled
+            ? 0.0f
+            : g_application.Configuration.FrameRateLimit,
+        .BackgroundFrameRate = g_application.Configuration.BackgroundFrameRate,
+        .VSyncRefreshRate = g_application.Configuration.IsVSyncEnabled
+            ? static_cast<float>(g_application.Context.ScreenRefreshRate)
+            : 0.0f,
+    });
+
+    auto isDumpingMemoryTelemetry = !g_application.Configuration.MemoryTelemetryPath.empty();
+    auto lastMemoryTelemetryDumpTime = currentTime;
+
+    auto isRecordingInput = !g_application.Configuration.RecordInputJournalPath.empty();
+    SInputJournal inputJournal = {
+        .WorldSeed = g_world.Seed,
+        .TickDeltaTime = physicsDeltaTime,
+    };
+
     while (!glfwWindowShouldClose(g_application.Window)) {
 
         HandleResize();
@@ -224,15 +310,22 @@ auto RunApplication() -> void {
         auto newTime = glfwGetTime();
         auto frameTime = newTime - currentTime;
         currentTime = newTime;
-        accumulator += frameTime;
 
-        HandleInput(g_world.EntityRegistry.get<SPhysicsComponent>(g_world.PlayerEntity).Body);
+        auto isInBackground = !g_application.IsWindowFocused;
+        auto stepCount = AdvanceFramePacer(framePacer, frameTime, isInBackground);
+
+        auto inputButtons = SampleInputButtons();
         
-        while (accumulator >= physicsDeltaTime) {
+        for (auto stepIndex = 0; stepIndex < stepCount; stepIndex++) {
+            ApplyInput(inputButtons);
             UpdateWorld(g_world.EntityRegistry, g_world.PhysicsWorld, physicsDeltaTime);
 
-            accumulator -= physicsDeltaTime;
-            lastPhysicsUpdateTime = newTime;
+            if (isRecordingInput) {
+                inputJournal.Ticks.push_back({
+                    .InputButtons = inputButtons,
+                    .WorldChecksum = ComputeWorldChecksum(g_world.EntityRegistry)
+                });
+            }
         }
 
         UpdateGpuResources(g_world.EntityRegistry);
@@ -241,9 +334,93 @@ auto RunApplication() -> void {
         glfwSwapBuffers(g_application.Window);
         glfwPollEvents();
 
-        if (!g_application.IsWindowFocused) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        EndMemoryTelemetryFrame();
+        if (isDumpingMemoryTelemetry && newTime - lastMemoryTelemetryDumpTime >= g_memoryTelemetryDumpInterval) {
+            WriteMemoryTelemetry(g_application.Configuration.MemoryTelemetryPath);
+            lastMemoryTelemetryDumpTime = newTime;
         }
+
+        WaitForNextFrame(framePacer, isInBackground);
+    }
+
+    LogFramePacingStatistics(framePacer);
+    LogMemoryTelemetry();
+    LogWorldChunkStatistics();
+    if (isDumpingMemoryTelemetry) {
+        WriteMemoryTelemetry(g_application.Configuration.MemoryTelemetryPath);
+    }
+
+    if (isRecordingInput) {
+        SaveInputJournal(g_application.Configuration.RecordInputJournalPath, inputJournal);
+    }
+}
+
+auto RunReplay(std::string_view inputJournalPath, std::string_view memoryTelemetryPath) -> bool {
+
+    auto inputJournal = LoadInputJournal(inputJournalPath);
+    if (!inputJournal) {
+        return false;
     }
 
+    InitializeWorld(inputJournal->WorldSeed);
+
+    auto tickDurations = std::vector<double>();
+    tickDurations.reserve(inputJournal->Ticks.size());
+
+    auto divergedTickCount = 0u;
+    for (auto tickIndex = 0u; tickIndex < inputJournal->Ticks.size(); tickIndex++) {
+
+        const auto& tick = inputJournal->Ticks[tickIndex];
+
+        auto tickStartTime = std::chrono::steady_clock::now();
+        ApplyInput(tick.InputButtons);
+        UpdateWorld(g_world.EntityRegistry, g_world.PhysicsWorld, inputJournal->TickDeltaTime);
+        auto tickEndTime = std::chrono::steady_clock::now();
+
+        tickDurations.push_back(std::chrono::duration<double, std::milli>(tickEndTime - tickStartTime).count());
+        EndMemoryTelemetryFrame();
+
+        if (ComputeWorldChecksum(g_world.EntityRegistry) != tick.WorldChecksum) {
+            if (divergedTickCount == 0) {
+                spdlog::error("{} Diverged from the recording at tick {}", "Replay", tickIndex);
+            }
+            divergedTickCount++;
+        }
+    }
+
+    LogMemoryTelemetry();
+    LogWorldChunkStatistics();
+    if (!memoryTelemetryPath.empty()) {
+        WriteMemoryTelemetry(memoryTelemetryPath);
+    }
+    ShutdownWorld();
+
+    if (!tickDurations.empty()) {
+        auto totalDuration = 0.0;
+        for (auto tickDuration : tickDurations) {
+            totalDuration += tickDuration;
+        }
+
+        std::ranges::sort(tickDurations);
+        auto percentile = [&](double fraction) {
+            return tickDurations[static_cast<size_t>(fraction * static_cast<double>(tickDurations.size() - 1))];
+        };
+
+        spdlog::info("{} {} ticks in {:.3f}ms, tick ms min {:.4f} p50 {:.4f} p95 {:.4f} p99 {:.4f} max {:.4f}",
+            "Replay",
+            tickDurations.size(),
+            totalDuration,
+            tickDurations.front(),
+            percentile(0.50),
+            percentile(0.95),
+            percentile(0.99),
+            tickDurations.back());
+    }
+
+    if (divergedTickCount > 0) {
+        spdlog::error("{} {} of {} ticks diverged", "Replay", divergedTickCount, inputJournal->Ticks.size());
+        return false;
+    }
+
+    return true;
 }
\ No newline at end of file
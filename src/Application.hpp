@@ -21,13 +21,22 @@ struct SApplicationConfiguration {
     uint32_t Height;
     std::string_view Title;
     float ResolutionScale;
+    // milliseconds, dynamic resolution holds the scene pass at this cost, 0 keeps ResolutionScale fixed
+    float TargetGpuFrameTime;
     EWindowStyle WindowStyle;
     bool IsDebug;
     bool IsVSyncEnabled;
+    int32_t MaxStepsPerFrame;
+    float FrameRateLimit;
+    float BackgroundFrameRate;
+    std::string_view RecordInputJournalPath;
+    std::string_view MemoryTelemetryPath;
 };
 
 struct SApplicationContext {
     glm::ivec2 ScreenSize;
+    // of the primary monitor in hz
+    int32_t ScreenRefreshRate;
     glm::ivec2 WindowSize;
     glm::ivec2 FramebufferSize;
     bool IsFramebufferResized;
@@ -40,10 +49,12 @@ struct SApplication {
     SApplicationContext Context = {};
     glm::vec2 CursorPosition = {};
     bool IsWindowFocused = true;
+    bool IsCursorInsideWindow = true;
 };
 
 extern SApplication g_application;
 
 auto InitializeApplication(const SApplicationConfiguration& applicationConfiguration) -> bool;
 auto ShutdownApplication() -> void;
-auto RunApplication() -> void;
\ No newline at end of file
+auto RunApplication() -> void;
+auto RunReplay(std::string_view inputJournalPath, std::string_view memoryTelemetryPath) -> bool;
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "MemoryTelemetry.hpp"
+#include "b2_user_settings.h"
+
+#include <cstddef>
+#include <cstdlib>
+
+// b2Free does not pass the size back, so every Box2D block carries it in front,
+// padded to keep the block itself at max alignment
+constexpr size_t g_box2DAllocationHeaderSize = alignof(std::max_align_t);
+
+auto AllocateBox2DMemory(int32 size) -> void* {
+
+    auto block = static_cast<std::byte*>(std::malloc(g_box2DAllocationHeaderSize + static_cast<size_t>(size)));
+    if (block == nullptr) {
+        return nullptr;
+    }
+
+    *reinterpret_cast<size_t*>(block) = static_cast<size_t>(size);
+    TrackAllocation(EMemorySubsystem::Box2D, static_cast<size_t>(size));
+
+    return block + g_box2DAllocationHeaderSize;
+}
+
+auto FreeBox2DMemory(void* memory) -> void {
+
+    if (memory == nullptr) {
+        return;
+    }
+
+    auto block = static_cast<std::byte*>(memory) - g_box2DAllocationHeaderSize;
+    TrackDeallocation(EMemorySubsystem::Box2D, *reinterpret_cast<size_t*>(block));
+
+    std::free(block);
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <box2d/box2d.h>
+#include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 
 struct SPlayerComponent {
@@ -23,4 +24,14 @@ struct SPositionComponent {
 
 struct SColorComponent {
     glm::vec4 Color;
+};
+
+struct SSpriteLayerComponent {
+    uint8_t Layer;
+};
+
+struct SChunkComponent {
+    glm::ivec2 Coordinate;
+    // position in the chunk's Entities, so leaving the chunk does not have to search for it
+    uint32_t EntityIndex;
 };
\ No newline at end of file
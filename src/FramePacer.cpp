@@ -0,0 +1,137 @@
+#include "FramePacer.hpp"
+
+#include <spdlog/spdlog.h>
+#include <spdlog/fmt/ranges.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// sleeping overshoots by up to a scheduler tick, the rest of the wait is spent spinning
+constexpr auto g_frameLimiterSpinDuration = std::chrono::microseconds(2000);
+// frames this much slower than the period they aimed for count as a missed deadline
+constexpr double g_missedDeadlineTolerance = 1.2;
+
+auto static GetFramePeriod(const SFramePacingConfiguration& framePacingConfiguration, bool isInBackground) -> double {
+
+    auto frameRate = isInBackground
+        ? framePacingConfiguration.BackgroundFrameRate
+        : framePacingConfiguration.FrameRateLimit;
+
+    return frameRate > 0.0f
+        ? 1.0 / frameRate
+        : 0.0;
+}
+
+auto CreateFramePacer(const SFramePacingConfiguration& framePacingConfiguration) -> SFramePacer {
+
+    auto framePacer = SFramePacer{
+        .Configuration = framePacingConfiguration,
+        .Statistics = {
+            .MinTimeScale = 1.0,
+        },
+        .NextFrameTime = std::chrono::steady_clock::now(),
+    };
+    framePacer.Configuration.MaxStepsPerFrame = std::max(framePacer.Configuration.MaxStepsPerFrame, 1);
+
+    return framePacer;
+}
+
+auto AdvanceFramePacer(SFramePacer& framePacer, double frameTime, bool isInBackground) -> int32_t {
+
+    const auto fixedDeltaTime = static_cast<double>(framePacer.Configuration.FixedDeltaTime);
+    const auto maxStepsPerFrame = framePacer.Configuration.MaxStepsPerFrame;
+
+    framePacer.Accumulator += frameTime;
+
+    auto stepCount = static_cast<int32_t>(std::min(
+        framePacer.Accumulator / fixedDeltaTime,
+        static_cast<double>(maxStepsPerFrame)));
+    framePacer.Accumulator -= stepCount * fixedDeltaTime;
+
+    auto& statistics = framePacer.Statistics;
+    auto droppedTime = 0.0;
+    if (framePacer.Accumulator >= fixedDeltaTime) {
+        // over budget, keep the fraction of a step and drop the whole steps we can't afford
+        droppedTime = framePacer.Accumulator - std::fmod(framePacer.Accumulator, fixedDeltaTime);
+        framePacer.Accumulator -= droppedTime;
+        statistics.DroppedTime += droppedTime;
+        statistics.DilatedFrameCount++;
+    }
+
+    framePacer.TimeScale = frameTime > 0.0
+        ? (frameTime - droppedTime) / frameTime
+        : 1.0;
+    statistics.MinTimeScale = std::min(statistics.MinTimeScale, framePacer.TimeScale);
+    statistics.RealTime += frameTime;
+
+    // the deadline is whatever paces the frame: the limiter, vsync, or without either the fixed step
+    auto deadlinePeriod = GetFramePeriod(framePacer.Configuration, isInBackground);
+    if (deadlinePeriod == 0.0 && framePacer.Configuration.VSyncRefreshRate > 0.0f) {
+        deadlinePeriod = 1.0 / framePacer.Configuration.VSyncRefreshRate;
+    }
+    if (deadlinePeriod == 0.0) {
+        deadlinePeriod = fixedDeltaTime;
+    }
+    if (frameTime > deadlinePeriod * g_missedDeadlineTolerance) {
+        statistics.MissedDeadlineCount++;
+    }
+
+    statistics.FrameCount++;
+    statistics.StepCount += stepCount;
+    statistics.StepCountHistogram[std::min<size_t>(stepCount, g_stepCountHistogramSize - 1)]++;
+
+    return stepCount;
+}
+
+auto WaitForNextFrame(SFramePacer& framePacer, bool isInBackground) -> void {
+
+    const auto framePeriod = GetFramePeriod(framePacer.Configuration, isInBackground);
+    if (framePeriod == 0.0) {
+        return;
+    }
+
+    const auto framePeriodDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(framePeriod));
+
+    auto now = std::chrono::steady_clock::now();
+    framePacer.NextFrameTime += framePeriodDuration;
+
+    // more than a frame late, catching up would only produce a burst of unpaced frames
+    if (now > framePacer.NextFrameTime + framePeriodDuration) {
+        framePacer.NextFrameTime = now;
+        return;
+    }
+
+    if (framePacer.NextFrameTime - now > g_frameLimiterSpinDuration) {
+        std::this_thread::sleep_until(framePacer.NextFrameTime - g_frameLimiterSpinDuration);
+    }
+
+    while (std::chrono::steady_clock::now() < framePacer.NextFrameTime) {
+        std::this_thread::yield();
+    }
+}
+
+auto LogFramePacingStatistics(const SFramePacer& framePacer) -> void {
+
+    const auto& statistics = framePacer.Statistics;
+
+    spdlog::info("{} {} frames, {} steps, {} missed deadlines, {} dilated frames, {:.3f}s of simulation dropped",
+        "FramePacer",
+        statistics.FrameCount,
+        statistics.StepCount,
+        statistics.MissedDeadlineCount,
+        statistics.DilatedFrameCount,
+        statistics.DroppedTime);
+
+    auto averageTimeScale = statistics.RealTime > 0.0
+        ? (statistics.RealTime - statistics.DroppedTime) / statistics.RealTime
+        : 1.0;
+    spdlog::info("{} Time scale average {:.3f}, min {:.3f} over {:.1f}s",
+        "FramePacer",
+        averageTimeScale,
+        statistics.MinTimeScale,
+        statistics.RealTime);
+
+    spdlog::info("{} Steps per frame histogram {}", "FramePacer", statistics.StepCountHistogram);
+}
\ No newline at end of file
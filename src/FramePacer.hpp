@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+struct SFramePacingConfiguration {
+    float FixedDeltaTime;
+    int32_t MaxStepsPerFrame;
+    // frames per second, 0 leaves the frame rate to vsync or unlimited
+    float FrameRateLimit;
+    // frames per second while the window is not focused, the simulation keeps running
+    float BackgroundFrameRate;
+    // refresh rate the swap waits for when vsync is on, 0 without vsync. Only used as the deadline
+    // for missed frames when there is no FrameRateLimit
+    float VSyncRefreshRate;
+};
+
+// index n counts frames which ran n fixed steps, the last bucket collects everything above
+constexpr size_t g_stepCountHistogramSize = 9;
+
+struct SFramePacingStatistics {
+    uint64_t FrameCount;
+    uint64_t StepCount;
+    uint64_t MissedDeadlineCount;
+    uint64_t DilatedFrameCount;
+    double RealTime;
+    double DroppedTime;
+    // lowest TimeScale seen in a single frame
+    double MinTimeScale;
+    std::array<uint64_t, g_stepCountHistogramSize> StepCountHistogram;
+};
+
+struct SFramePacer {
+    SFramePacingConfiguration Configuration = {};
+    SFramePacingStatistics Statistics = {};
+    double Accumulator = 0.0;
+    // simulated time over real time of the last frame, below 1 when steps were capped
+    double TimeScale = 1.0;
+    std::chrono::steady_clock::time_point NextFrameTime = {};
+};
+
+auto CreateFramePacer(const SFramePacingConfiguration& framePacingConfiguration) -> SFramePacer;
+
+// Feeds the real time of the last frame into the accumulator and returns how many fixed
+// steps to run. Anything beyond MaxStepsPerFrame is dropped, which dilates simulated time
+// instead of spiraling after a hitch.
+auto AdvanceFramePacer(SFramePacer& framePacer, double frameTime, bool isInBackground) -> int32_t;
+
+// Sleeps, then spins for the last bit, until the next frame is due. Does nothing
+// when there is no frame rate limit for the current mode.
+auto WaitForNextFrame(SFramePacer& framePacer, bool isInBackground) -> void;
+
+auto LogFramePacingStatistics(const SFramePacer& framePacer) -> void;
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "InputJournal.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <fstream>
+
+// File layout, little endian as written by the host:
+//   char[4]  magic "FSIJ"
+//   uint32   version
+//   uint32   world seed
+//   float    tick delta time
+//   uint32   tick count
+//   tick count * { uint8 input buttons, uint32 world checksum }
+constexpr std::array<char, 4> g_inputJournalMagic = {'F', 'S', 'I', 'J'};
+constexpr uint32_t g_inputJournalVersion = 1;
+constexpr uint64_t g_inputJournalTickSize = sizeof(uint8_t) + sizeof(uint32_t);
+
+template<typename T>
+auto static WriteValue(std::ofstream& stream, const T& value) -> void {
+
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+auto static ReadValue(std::ifstream& stream, T& value) -> bool {
+
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return stream.good();
+}
+
+auto SaveInputJournal(std::string_view filePath, const SInputJournal& inputJournal) -> bool {
+
+    std::ofstream fileStream{ filePath.data(), std::ios::binary | std::ios::trunc };
+    if (!fileStream) {
+        spdlog::error("{} Unable to open {} for writing", "InputJournal", filePath);
+        return false;
+    }
+
+    fileStream.write(g_inputJournalMagic.data(), g_inputJournalMagic.size());
+    WriteValue(fileStream, g_inputJournalVersion);
+    WriteValue(fileStream, inputJournal.WorldSeed);
+    WriteValue(fileStream, inputJournal.TickDeltaTime);
+    WriteValue(fileStream, static_cast<uint32_t>(inputJournal.Ticks.size()));
+
+    for (const auto& tick : inputJournal.Ticks) {
+        WriteValue(fileStream, tick.InputButtons);
+        WriteValue(fileStream, tick.WorldChecksum);
+    }
+
+    if (!fileStream) {
+        spdlog::error("{} Unable to write {}", "InputJournal", filePath);
+        return false;
+    }
+
+    spdlog::info("{} Wrote {} ticks to {}", "InputJournal", inputJournal.Ticks.size(), filePath);
+    return true;
+}
+
+auto LoadInputJournal(std::string_view filePath) -> std::optional<SInputJournal> {
+
+    std::ifstream fileStream{ filePath.data(), std::ios::binary };
+    if (!fileStream) {
+        spdlog::error("{} Unable to open {}", "InputJournal", filePath);
+        return {};
+    }
+
+    std::array<char, 4> magic = {};
+    uint32_t version = 0;
+    uint32_t tickCount = 0;
+    SInputJournal inputJournal = {};
+
+    fileStream.read(magic.data(), magic.size());
+    if (!fileStream || magic != g_inputJournalMagic) {
+        spdlog::error("{} {} is not an input journal", "InputJournal", filePath);
+        return {};
+    }
+
+    if (!ReadValue(fileStream, version) || version != g_inputJournalVersion) {
+        spdlog::error("{} {} has unsupported version {}", "InputJournal", filePath, version);
+        return {};
+    }
+
+    if (!ReadValue(fileStream, inputJournal.WorldSeed) ||
+        !ReadValue(fileStream, inputJournal.TickDeltaTime) ||
+        !ReadValue(fileStream, tickCount)) {
+        spdlog::error("{} {} has a truncated header", "InputJournal", filePath);
+        return {};
+    }
+
+    // the count comes from the file, don't let a corrupt one allocate more than the file can hold
+    const auto tickDataOffset = fileStream.tellg();
+    fileStream.seekg(0, std::ios::end);
+    const auto remainingByteCount = static_cast<uint64_t>(fileStream.tellg() - tickDataOffset);
+    fileStream.seekg(tickDataOffset);
+    if (!fileStream || tickCount * g_inputJournalTickSize > remainingByteCount) {
+        spdlog::error("{} {} is truncated, {} ticks need {} bytes but {} are left",
+            "InputJournal",
+            filePath,
+            tickCount,
+            tickCount * g_inputJournalTickSize,
+            remainingByteCount);
+        return {};
+    }
+
+    inputJournal.Ticks.resize(tickCount);
+    for (auto& tick : inputJournal.Ticks) {
+        if (!ReadValue(fileStream, tick.InputButtons) || !ReadValue(fileStream, tick.WorldChecksum)) {
+            spdlog::error("{} {} is truncated", "InputJournal", filePath);
+            return {};
+        }
+    }
+
+    return inputJournal;
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+enum EInputButton : uint8_t {
+    MoveUp = 1,
+    MoveDown = 2,
+    MoveLeft = 4,
+    MoveRight = 8
+};
+
+struct SInputJournalTick {
+    uint8_t InputButtons;
+    uint32_t WorldChecksum;
+};
+
+// Everything needed to replay a session tick by tick: the level seed, the fixed step
+// and the input that was applied before each step, plus the world checksum after it.
+struct SInputJournal {
+    uint32_t WorldSeed;
+    float TickDeltaTime;
+    std::vector<SInputJournalTick> Ticks;
+};
+
+auto SaveInputJournal(std::string_view filePath, const SInputJournal& inputJournal) -> bool;
+auto LoadInputJournal(std::string_view filePath) -> std::optional<SInputJournal>;
\ No newline at end of file
@@ -5,16 +5,22 @@
 
 #include <spdlog/spdlog.h>
 
+#include <random>
+
 constexpr std::string_view g_gameTitle = "FwogSurvivors";
 
 auto Initialize() -> bool {
 
-    if (!InitializeRenderer(g_application.Configuration.IsDebug)) {
+    if (!InitializeRenderer(
+        g_application.Configuration.IsDebug,
+        g_application.Context.FramebufferSize,
+        g_application.Configuration.ResolutionScale,
+        g_application.Configuration.TargetGpuFrameTime)) {
 
         return false;
     }
 
-    InitializeWorld();
+    InitializeWorld(std::random_device{}());
     
     return true;
 }
@@ -27,17 +33,44 @@ auto Shutdown() -> void {
 }
 
 int32_t main(
-    [[maybe_unused]] int32_t argc,
-    [[maybe_unused]] char* argv[]) {
+    int32_t argc,
+    char* argv[]) {
+
+    // --record <file> journals every tick of a normal session
+    // --replay <file> runs a journal headless and reports tick timings
+    // --memory-telemetry <file> dumps per subsystem memory statistics as json
+    std::string_view recordInputJournalPath = {};
+    std::string_view replayInputJournalPath = {};
+    std::string_view memoryTelemetryPath = {};
+    for (int32_t argumentIndex = 1; argumentIndex + 1 < argc; argumentIndex++) {
+        auto argument = std::string_view(argv[argumentIndex]);
+        if (argument == "--record") {
+            recordInputJournalPath = argv[++argumentIndex];
+        } else if (argument == "--replay") {
+            replayInputJournalPath = argv[++argumentIndex];
+        } else if (argument == "--memory-telemetry") {
+            memoryTelemetryPath = argv[++argumentIndex];
+        }
+    }
+
+    if (!replayInputJournalPath.empty()) {
+        return RunReplay(replayInputJournalPath, memoryTelemetryPath) ? 0 : 1;
+    }
 
     if (!InitializeApplication({
         .Width = 1920,
         .Height = 1080,
         .Title = g_gameTitle,
         .ResolutionScale = 1.0f,
+        .TargetGpuFrameTime = 12.0f,
         .WindowStyle = EWindowStyle::Windowed,
         .IsDebug = true,
-        .IsVSyncEnabled = true
+        .IsVSyncEnabled = true,
+        .MaxStepsPerFrame = 8,
+        .FrameRateLimit = 144.0f,
+        .BackgroundFrameRate = 10.0f,
+        .RecordInputJournalPath = recordInputJournalPath,
+        .MemoryTelemetryPath = memoryTelemetryPath
     })) {
         spdlog::error("{} Unable to initialize", g_gameTitle);
         Shutdown();
@@ -0,0 +1,117 @@
+#include "MemoryTelemetry.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <atomic>
+#include <fstream>
+
+struct SMemorySubsystemCounters {
+    std::atomic<uint64_t> LiveBytes;
+    std::atomic<uint64_t> PeakBytes;
+    std::atomic<uint64_t> AllocationCount;
+    std::atomic<uint64_t> FrameAllocationCount;
+    std::atomic<uint64_t> LastFrameAllocationCount;
+    std::atomic<uint64_t> PeakFrameAllocationCount;
+};
+
+constexpr auto g_memorySubsystemCount = static_cast<size_t>(EMemorySubsystem::Count);
+constexpr std::array<std::string_view, g_memorySubsystemCount> g_memorySubsystemNames = {
+    "Box2D",
+    "EnTT",
+    "GpuStaging"
+};
+
+std::array<SMemorySubsystemCounters, g_memorySubsystemCount> g_memorySubsystemCounters = {};
+std::atomic<uint64_t> g_memoryTelemetryFrameCount = 0;
+
+auto static GetCounters(EMemorySubsystem memorySubsystem) -> SMemorySubsystemCounters& {
+
+    return g_memorySubsystemCounters[static_cast<size_t>(memorySubsystem)];
+}
+
+auto static UpdatePeak(std::atomic<uint64_t>& peak, uint64_t value) -> void {
+
+    auto currentPeak = peak.load(std::memory_order_relaxed);
+    while (value > currentPeak && !peak.compare_exchange_weak(currentPeak, value, std::memory_order_relaxed)) {
+    }
+}
+
+auto TrackAllocation(EMemorySubsystem memorySubsystem, size_t size) -> void {
+
+    auto& counters = GetCounters(memorySubsystem);
+    auto liveBytes = counters.LiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    UpdatePeak(counters.PeakBytes, liveBytes);
+    counters.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    counters.FrameAllocationCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto TrackDeallocation(EMemorySubsystem memorySubsystem, size_t size) -> void {
+
+    GetCounters(memorySubsystem).LiveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+auto EndMemoryTelemetryFrame() -> void {
+
+    for (auto& counters : g_memorySubsystemCounters) {
+        auto frameAllocationCount = counters.FrameAllocationCount.exchange(0, std::memory_order_relaxed);
+        counters.LastFrameAllocationCount.store(frameAllocationCount, std::memory_order_relaxed);
+        UpdatePeak(counters.PeakFrameAllocationCount, frameAllocationCount);
+    }
+
+    g_memoryTelemetryFrameCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto GetMemorySubsystemStatistics(EMemorySubsystem memorySubsystem) -> SMemorySubsystemStatistics {
+
+    const auto& counters = GetCounters(memorySubsystem);
+    return SMemorySubsystemStatistics{
+        .LiveBytes = counters.LiveBytes.load(std::memory_order_relaxed),
+        .PeakBytes = counters.PeakBytes.load(std::memory_order_relaxed),
+        .AllocationCount = counters.AllocationCount.load(std::memory_order_relaxed),
+        .LastFrameAllocationCount = counters.LastFrameAllocationCount.load(std::memory_order_relaxed),
+        .PeakFrameAllocationCount = counters.PeakFrameAllocationCount.load(std::memory_order_relaxed),
+    };
+}
+
+auto LogMemoryTelemetry() -> void {
+
+    for (auto subsystemIndex = 0u; subsystemIndex < g_memorySubsystemCount; subsystemIndex++) {
+        auto statistics = GetMemorySubsystemStatistics(static_cast<EMemorySubsystem>(subsystemIndex));
+        spdlog::info("{} {} live {} bytes, peak {} bytes, {} allocations, last frame {}, peak frame {}",
+            "MemoryTelemetry",
+            g_memorySubsystemNames[subsystemIndex],
+            statistics.LiveBytes,
+            statistics.PeakBytes,
+            statistics.AllocationCount,
+            statistics.LastFrameAllocationCount,
+            statistics.PeakFrameAllocationCount);
+    }
+}
+
+auto WriteMemoryTelemetry(std::string_view filePath) -> bool {
+
+    std::ofstream fileStream{ filePath.data(), std::ios::trunc };
+    if (!fileStream) {
+        spdlog::error("{} Unable to open {} for writing", "MemoryTelemetry", filePath);
+        return false;
+    }
+
+    fileStream << "{\n";
+    fileStream << "  \"frames\": " << g_memoryTelemetryFrameCount.load(std::memory_order_relaxed) << ",\n";
+    fileStream << "  \"subsystems\": {\n";
+    for (auto subsystemIndex = 0u; subsystemIndex < g_memorySubsystemCount; subsystemIndex++) {
+        auto statistics = GetMemorySubsystemStatistics(static_cast<EMemorySubsystem>(subsystemIndex));
+        fileStream << "    \"" << g_memorySubsystemNames[subsystemIndex] << "\": {"
+                   << " \"liveBytes\": " << statistics.LiveBytes
+                   << ", \"peakBytes\": " << statistics.PeakBytes
+                   << ", \"allocations\": " << statistics.AllocationCount
+                   << ", \"lastFrameAllocations\": " << statistics.LastFrameAllocationCount
+                   << ", \"peakFrameAllocations\": " << statistics.PeakFrameAllocationCount
+                   << " }" << (subsystemIndex + 1 < g_memorySubsystemCount ? ",\n" : "\n");
+    }
+    fileStream << "  }\n";
+    fileStream << "}\n";
+
+    return fileStream.good();
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string_view>
+
+enum class EMemorySubsystem : uint32_t {
+    Box2D,
+    EnTT,
+    GpuStaging,
+    Count
+};
+
+struct SMemorySubsystemStatistics {
+    uint64_t LiveBytes;
+    uint64_t PeakBytes;
+    uint64_t AllocationCount;
+    uint64_t LastFrameAllocationCount;
+    uint64_t PeakFrameAllocationCount;
+};
+
+// Counters are atomic, any thread may allocate through a tracked subsystem.
+auto TrackAllocation(EMemorySubsystem memorySubsystem, size_t size) -> void;
+auto TrackDeallocation(EMemorySubsystem memorySubsystem, size_t size) -> void;
+
+// Closes the per frame allocation counts, call once per frame (or tick when headless).
+auto EndMemoryTelemetryFrame() -> void;
+
+auto GetMemorySubsystemStatistics(EMemorySubsystem memorySubsystem) -> SMemorySubsystemStatistics;
+auto LogMemoryTelemetry() -> void;
+auto WriteMemoryTelemetry(std::string_view filePath) -> bool;
+
+// Standard allocator which accounts every allocation to TSubsystem.
+template<typename T, EMemorySubsystem TSubsystem>
+struct STrackingAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = STrackingAllocator<U, TSubsystem>;
+    };
+
+    STrackingAllocator() noexcept = default;
+
+    template<typename U>
+    STrackingAllocator(const STrackingAllocator<U, TSubsystem>&) noexcept {}
+
+    [[nodiscard]] auto allocate(size_t count) -> T* {
+
+        auto memory = static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{alignof(T)}));
+        TrackAllocation(TSubsystem, count * sizeof(T));
+        return memory;
+    }
+
+    auto deallocate(T* memory, size_t count) noexcept -> void {
+
+        TrackDeallocation(TSubsystem, count * sizeof(T));
+        ::operator delete(memory, count * sizeof(T), std::align_val_t{alignof(T)});
+    }
+
+    template<typename U>
+    auto operator==(const STrackingAllocator<U, TSubsystem>&) const noexcept -> bool {
+        return true;
+    }
+};
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Renderer.hpp"
 #include "Components.hpp"
+#include "ResolutionScaler.hpp"
+#include "SpriteSort.hpp"
 
 #include <Fwog/Buffer.h>
 #include <Fwog/Context.h>
@@ -7,6 +9,7 @@
 #include <Fwog/Rendering.h>
 #include <Fwog/Shader.h>
 #include <Fwog/Texture.h>
+#include <Fwog/Timer.h>
 
 #include <glad/glad.h>
 #include <debugbreak.h>
@@ -19,12 +22,17 @@
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 #include <glm/mat4x4.hpp>
+#include <glm/common.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <bit>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <span>
+#include <vector>
 
 struct SGpuCameraInformation {
     glm::mat4x4 ProjectionMatrix;
@@ -42,11 +50,30 @@ std::optional<Fwog::TypedBuffer<SGpuSprite>> g_gpuSpriteBuffer = {};
 std::optional<Fwog::Buffer> g_gpuSpriteTextureHandleBuffer = {};
 std::optional<Fwog::Texture> g_frogTexture = {};
 std::optional<Fwog::Sampler> g_defaultSampler = {};
+std::optional<Fwog::Texture> g_sceneColorTexture = {};
+std::optional<Fwog::TimerQueryAsync> g_sceneGpuTimer = {};
 
 SGpuCameraInformation g_gpuCameraInformation = {};
 
+constexpr uint32_t g_initialSpriteCapacity = 8192;
+constexpr float g_minResolutionScale = 0.5f;
+
+SResolutionScaleController g_resolutionScaleController = {};
+glm::ivec2 g_sceneTargetSize = {};
+
+template<typename T>
+using TGpuStagingVector = std::vector<T, STrackingAllocator<T, EMemorySubsystem::GpuStaging>>;
+
+TGpuStagingVector<SGpuSprite> g_stagedSprites = {};
+TGpuStagingVector<uint64_t> g_stagedSpriteTextureHandles = {};
+TGpuStagingVector<SGpuSprite> g_sortedSprites = {};
+TGpuStagingVector<uint64_t> g_sortedSpriteTextureHandles = {};
+TSpriteSortEntries g_spriteSortEntries = {};
+TSpriteSortEntries g_spriteSortScratch = {};
+
 uint64_t g_frogTextureHandle = 0;
 int32_t g_spriteCount = 0;
+uint32_t g_spriteCapacity = 0;
 
 auto static OnDebugMessageCallback(
     [[maybe_unused]] uint32_t source,
@@ -129,8 +156,10 @@ auto CreateGraphicsPipeline() -> std::optional<Fwog::GraphicsPipeline> {
         },
         .depthState =
         {
-            .depthTestEnable = true,
-            .depthWriteEnable = true,
+            // sprites are drawn back to front in sort key order, depth would only
+            // throw away blended fragments of sprites sharing the same z
+            .depthTestEnable = false,
+            .depthWriteEnable = false,
             .depthCompareOp = Fwog::CompareOp::LESS,
             
         },
@@ -146,18 +175,43 @@ auto CreateGraphicsPipeline() -> std::optional<Fwog::GraphicsPipeline> {
     }};
 }
 
-auto CreateBuffers() -> void {
+auto UpdateCameraInformation(glm::ivec2 framebufferSize) -> void {
 
-    auto viewportWidth = 1920 / 2.0f;//g_application.Context.FramebufferSize.x / 2.0f;
-    auto viewportHeight = 1080 / 2.0f;//g_application.Context.FramebufferSize.y / 2.0f;
+    auto viewportWidth = framebufferSize.x / 2.0f;
+    auto viewportHeight = framebufferSize.y / 2.0f;
     g_gpuCameraInformation.ProjectionMatrix = glm::orthoRH(-viewportWidth, viewportWidth, viewportHeight, -viewportHeight, -20.0f, 20.0f);
 
     auto cameraPosition = glm::vec3(0.0f, 0.0f, 0.0f);
     auto cameraDirection = glm::vec3(0, 0, -1);
     auto cameraUp = glm::vec3(0, 1, 0);
     g_gpuCameraInformation.ViewMatrix = glm::lookAtRH(cameraPosition, cameraPosition + cameraDirection, cameraUp);
-    g_gpuCameraInformationBuffer = Fwog::Buffer(g_gpuCameraInformation, Fwog::BufferStorageFlag::DYNAMIC_STORAGE, "GpuCameraInformation");
     g_gpuCameraInformationBuffer->UpdateData(g_gpuCameraInformation, 0);
+}
+
+auto CreateSceneTargets(glm::ivec2 framebufferSize) -> void {
+
+    // sized for the largest scale, lower scales render into the top left corner of it
+    auto maxScale = g_resolutionScaleController.Configuration.MaxScale;
+    g_sceneTargetSize = glm::max(glm::ivec2(glm::ceil(glm::vec2(framebufferSize) * maxScale)), glm::ivec2(1));
+
+    g_sceneColorTexture = Fwog::CreateTexture2D({
+        static_cast<uint32_t>(g_sceneTargetSize.x),
+        static_cast<uint32_t>(g_sceneTargetSize.y)},
+        Fwog::Format::R8G8B8A8_SRGB,
+        "SceneColor");
+}
+
+auto static CreateSpriteBuffers(uint32_t spriteCapacity) -> void {
+
+    g_gpuSpriteBuffer = Fwog::TypedBuffer<SGpuSprite>(spriteCapacity, Fwog::BufferStorageFlag::DYNAMIC_STORAGE, "GpuSprites");
+    g_gpuSpriteTextureHandleBuffer = Fwog::Buffer(spriteCapacity * sizeof(uint64_t), Fwog::BufferStorageFlag::DYNAMIC_STORAGE, "SGpuSpriteTextureHandles");
+    g_spriteCapacity = spriteCapacity;
+}
+
+auto CreateBuffers(glm::ivec2 framebufferSize) -> void {
+
+    g_gpuCameraInformationBuffer = Fwog::Buffer(g_gpuCameraInformation, Fwog::BufferStorageFlag::DYNAMIC_STORAGE, "GpuCameraInformation");
+    UpdateCameraInformation(framebufferSize);
 
     g_defaultSampler = Fwog::Sampler(Fwog::SamplerState{
         .minFilter = Fwog::Filter::NEAREST,
@@ -166,7 +220,7 @@ auto CreateBuffers() -> void {
         .addressModeV = Fwog::AddressMode::REPEAT,
     });    
 
-    g_gpuSpriteBuffer = Fwog::TypedBuffer<SGpuSprite>(8192, Fwog::BufferStorageFlag::DYNAMIC_STORAGE, "GpuSprites");
+    CreateSpriteBuffers(g_initialSpriteCapacity);
 
     g_frogTexture = LoadTextureFromFile("data/sprites/frog.png");
 
@@ -174,11 +228,13 @@ auto CreateBuffers() -> void {
     if (g_frogTexture.has_value()) {
         g_frogTextureHandle = g_frogTexture.value().GetBindlessHandle(g_defaultSampler.value());
     }
-
-    g_gpuSpriteTextureHandleBuffer = Fwog::Buffer(8192, Fwog::BufferStorageFlag::DYNAMIC_STORAGE, "SGpuSpriteTextureHandles");
 }
 
-auto InitializeRenderer(bool isDebug) -> bool {
+auto InitializeRenderer(
+    bool isDebug,
+    glm::ivec2 framebufferSize,
+    float resolutionScale,
+    float targetGpuFrameTime) -> bool {
 
     if (gladLoadGL() == GL_FALSE) {
         spdlog::error("{} Unable to load OpenGL", "Renderer");
@@ -203,7 +259,15 @@ auto InitializeRenderer(bool isDebug) -> bool {
         return false;
     }
 
-    CreateBuffers();
+    CreateBuffers(framebufferSize);
+
+    g_resolutionScaleController = CreateResolutionScaleController({
+        .TargetFrameTime = targetGpuFrameTime,
+        .MinScale = std::min(g_minResolutionScale, resolutionScale),
+        .MaxScale = resolutionScale,
+    }, resolutionScale);
+    CreateSceneTargets(framebufferSize);
+    g_sceneGpuTimer.emplace(5);
 
     return true;
 }
@@ -214,58 +278,126 @@ auto ShutdownRenderer() -> void {
     g_gpuCameraInformationBuffer.reset();
     g_gpuSpriteBuffer.reset();
     g_gpuSpriteTextureHandleBuffer.reset();
+    g_spriteCapacity = 0;
     g_frogTexture.reset();
     g_defaultSampler.reset();
+    g_sceneColorTexture.reset();
+    g_sceneGpuTimer.reset();
 
     Fwog::Terminate();
 }
 
-auto UpdateGpuResources(const entt::registry& registry) -> void {
+auto ResizeRenderer(glm::ivec2 framebufferSize) -> void {
+
+    // minimized, keep the old targets around until there is something to render to again
+    if (framebufferSize.x <= 0 || framebufferSize.y <= 0) {
+        return;
+    }
+
+    UpdateCameraInformation(framebufferSize);
+    CreateSceneTargets(framebufferSize);
+}
+
+auto UpdateGpuResources(const TEntityRegistry& registry) -> void {
+
+    g_stagedSprites.clear();
+    g_stagedSpriteTextureHandles.clear();
+    g_spriteSortEntries.clear();
 
-    auto positionView = registry.view<SPositionComponent, SColorComponent>();
-    auto spriteIndex = 0;
-    g_spriteCount = 0;
-    positionView.each([&](auto& positionComponent, auto& colorComponent) {
+    auto spriteView = registry.view<SPositionComponent, SColorComponent, SSpriteLayerComponent>();
+    spriteView.each([&](auto& positionComponent, auto& colorComponent, auto& spriteLayerComponent) {
 
-        SGpuSprite gpuSprite = {
+        g_spriteSortEntries.push_back({
+            .Key = MakeSpriteSortKey(spriteLayerComponent.Layer, positionComponent.Position.y),
+            .Index = static_cast<uint32_t>(g_stagedSprites.size())
+        });
+        g_stagedSprites.push_back({
             .PositionAndRotation = glm::vec4(positionComponent.Position.x, positionComponent.Position.y, 0.0f, 1.0f),
             .Color = colorComponent.Color,
-        };
-        g_gpuSpriteBuffer->UpdateData(gpuSprite, spriteIndex);
-        g_gpuSpriteTextureHandleBuffer->UpdateData(g_frogTextureHandle, sizeof(uint64_t) * spriteIndex);
-
-        spriteIndex++;
-        g_spriteCount++;
+        });
+        g_stagedSpriteTextureHandles.push_back(g_frogTextureHandle);
     });
+
+    SortSpriteEntries(g_spriteSortEntries, g_spriteSortScratch, g_spriteSortAllHardwareThreads);
+
+    // cutting the sorted list would drop the top layers first, so grow the buffers instead
+    if (g_spriteSortEntries.size() > g_spriteCapacity) {
+        auto spriteCapacity = std::bit_ceil(static_cast<uint32_t>(g_spriteSortEntries.size()));
+        spdlog::info("{} Growing sprite buffers from {} to {} sprites", "Renderer", g_spriteCapacity, spriteCapacity);
+        CreateSpriteBuffers(spriteCapacity);
+    }
+
+    g_spriteCount = static_cast<int32_t>(g_spriteSortEntries.size());
+    g_sortedSprites.resize(g_spriteCount);
+    g_sortedSpriteTextureHandles.resize(g_spriteCount);
+    for (auto spriteIndex = 0; spriteIndex < g_spriteCount; spriteIndex++) {
+        auto stagedIndex = g_spriteSortEntries[spriteIndex].Index;
+        g_sortedSprites[spriteIndex] = g_stagedSprites[stagedIndex];
+        g_sortedSpriteTextureHandles[spriteIndex] = g_stagedSpriteTextureHandles[stagedIndex];
+    }
+
+    if (g_spriteCount > 0) {
+        g_gpuSpriteBuffer->UpdateData(std::span<const SGpuSprite>(g_sortedSprites));
+        g_gpuSpriteTextureHandleBuffer->UpdateData(std::span<const uint64_t>(g_sortedSpriteTextureHandles));
+    }
 }
 
 auto RenderWorld(glm::ivec2 framebufferSize) -> void {
 
-    Fwog::RenderToSwapchain(
-        Fwog::SwapchainRenderInfo {
-            .name = "RenderScene",
-            .viewport = Fwog::Viewport {
-                .drawRect {
-                    .offset = {0, 0},
-                    .extent = {
-                        static_cast<uint32_t>(framebufferSize.x),
-                        static_cast<uint32_t>(framebufferSize.y)
-                    }
+    if (framebufferSize.x <= 0 || framebufferSize.y <= 0) {
+        return;
+    }
+
+    auto sceneSize = glm::clamp(
+        glm::ivec2(glm::vec2(framebufferSize) * g_resolutionScaleController.Scale),
+        glm::ivec2(1),
+        g_sceneTargetSize);
+
+    auto sceneColorAttachment = Fwog::RenderColorAttachment{
+        .texture = g_sceneColorTexture.value(),
+        .loadOp = Fwog::AttachmentLoadOp::CLEAR,
+        .clearValue = {.2f, .4f, .1f, 1.0f},
+    };
+
+    {
+        Fwog::TimerScoped sceneGpuTimerScope(g_sceneGpuTimer.value());
+
+        Fwog::Render(
+            Fwog::RenderInfo {
+                .name = "RenderScene",
+                .viewport = Fwog::Viewport {
+                    .drawRect {
+                        .offset = {0, 0},
+                        .extent = {
+                            static_cast<uint32_t>(sceneSize.x),
+                            static_cast<uint32_t>(sceneSize.y)
+                        }
+                    },
+                    .depthRange = Fwog::ClipDepthRange::NEGATIVE_ONE_TO_ONE,
                 },
-                .depthRange = Fwog::ClipDepthRange::NEGATIVE_ONE_TO_ONE,
+                .colorAttachments = {&sceneColorAttachment, 1},
             },
-            .colorLoadOp = Fwog::AttachmentLoadOp::CLEAR,
-            .clearColorValue = {.2f, .4f, .1f, 1.0f},
-            .depthLoadOp = Fwog::AttachmentLoadOp::CLEAR,
-            .clearDepthValue = { 1.0f }
-        },
-    [&] {
+        [&] {
 
-        Fwog::Cmd::BindGraphicsPipeline(g_graphicsPipeline.value());
-        Fwog::Cmd::BindUniformBuffer("SGpuCameraInformationBuffer", g_gpuCameraInformationBuffer.value(), 0, sizeof(SGpuCameraInformation));
-        Fwog::Cmd::BindStorageBuffer("SGpuSpriteBuffer", g_gpuSpriteBuffer.value(), 0, Fwog::WHOLE_BUFFER);
-        Fwog::Cmd::BindStorageBuffer("SGpuSpriteTextureHandleBuffer", g_gpuSpriteTextureHandleBuffer.value(), 0, Fwog::WHOLE_BUFFER);
+            Fwog::Cmd::BindGraphicsPipeline(g_graphicsPipeline.value());
+            Fwog::Cmd::BindUniformBuffer("SGpuCameraInformationBuffer", g_gpuCameraInformationBuffer.value(), 0, sizeof(SGpuCameraInformation));
+            Fwog::Cmd::BindStorageBuffer("SGpuSpriteBuffer", g_gpuSpriteBuffer.value(), 0, Fwog::WHOLE_BUFFER);
+            Fwog::Cmd::BindStorageBuffer("SGpuSpriteTextureHandleBuffer", g_gpuSpriteTextureHandleBuffer.value(), 0, Fwog::WHOLE_BUFFER);
 
-        Fwog::Cmd::Draw(4, g_spriteCount, 0, 0);
-    });
+            Fwog::Cmd::Draw(4, g_spriteCount, 0, 0);
+        });
+    }
+
+    Fwog::BlitTextureToSwapchain(
+        g_sceneColorTexture.value(),
+        {0, 0, 0},
+        {0, 0, 0},
+        {static_cast<uint32_t>(sceneSize.x), static_cast<uint32_t>(sceneSize.y), 1},
+        {static_cast<uint32_t>(framebufferSize.x), static_cast<uint32_t>(framebufferSize.y), 1},
+        Fwog::Filter::LINEAR);
+
+    // the timer hands back results a few frames late, once the gpu is done with them
+    if (auto sceneGpuTime = g_sceneGpuTimer->PopTimestamp()) {
+        UpdateResolutionScale(g_resolutionScaleController, static_cast<float>(*sceneGpuTime) / 1'000'000.0f);
+    }
 }
\ No newline at end of file
@@ -1,10 +1,15 @@
 #pragma once
 
-#include <entt/entt.hpp>
+#include "World.hpp"
 #include <glm/vec2.hpp>
 
-auto InitializeRenderer(bool isDebug) -> bool;
+auto InitializeRenderer(
+    bool isDebug,
+    glm::ivec2 framebufferSize,
+    float resolutionScale,
+    float targetGpuFrameTime) -> bool;
 auto ShutdownRenderer() -> void;
+auto ResizeRenderer(glm::ivec2 framebufferSize) -> void;
 
-auto UpdateGpuResources(const entt::registry& registry) -> void;
+auto UpdateGpuResources(const TEntityRegistry& registry) -> void;
 auto RenderWorld(glm::ivec2 framebufferSize) -> void;
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "ResolutionScaler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// weight of the newest sample in the moving average of the gpu time
+constexpr float g_frameTimeSmoothing = 0.1f;
+// changes smaller than this are not worth a visible jump in sharpness
+constexpr float g_minScaleChange = 0.02f;
+// growing is capped per change so a single cheap frame does not overshoot
+constexpr float g_maxScaleIncrease = 0.05f;
+// frames between two changes, so the average reflects the current scale again
+constexpr uint32_t g_scaleChangeCooldown = 15;
+
+auto CreateResolutionScaleController(
+    const SResolutionScaleConfiguration& resolutionScaleConfiguration,
+    float initialScale) -> SResolutionScaleController {
+
+    return SResolutionScaleController{
+        .Configuration = resolutionScaleConfiguration,
+        .Scale = std::clamp(initialScale, resolutionScaleConfiguration.MinScale, resolutionScaleConfiguration.MaxScale),
+        .SmoothedFrameTime = resolutionScaleConfiguration.TargetFrameTime,
+        .FramesSinceScaleChange = 0,
+    };
+}
+
+auto UpdateResolutionScale(SResolutionScaleController& resolutionScaleController, float gpuFrameTime) -> float {
+
+    auto& controller = resolutionScaleController;
+    const auto& configuration = controller.Configuration;
+
+    if (gpuFrameTime <= 0.0f || configuration.TargetFrameTime <= 0.0f) {
+        return controller.Scale;
+    }
+
+    controller.SmoothedFrameTime += (gpuFrameTime - controller.SmoothedFrameTime) * g_frameTimeSmoothing;
+    controller.FramesSinceScaleChange++;
+
+    if (controller.FramesSinceScaleChange < g_scaleChangeCooldown) {
+        return controller.Scale;
+    }
+
+    // gpu time grows with the pixel count, which is the square of the scale
+    auto desiredScale = controller.Scale * std::sqrt(configuration.TargetFrameTime / controller.SmoothedFrameTime);
+    desiredScale = std::min(desiredScale, controller.Scale + g_maxScaleIncrease);
+    desiredScale = std::clamp(desiredScale, configuration.MinScale, configuration.MaxScale);
+
+    auto isAtScaleLimit = desiredScale == configuration.MinScale || desiredScale == configuration.MaxScale;
+    if (desiredScale == controller.Scale ||
+        (std::abs(desiredScale - controller.Scale) < g_minScaleChange && !isAtScaleLimit)) {
+        return controller.Scale;
+    }
+
+    // assume the cost follows the new pixel count until fresh samples come in
+    controller.SmoothedFrameTime *= (desiredScale * desiredScale) / (controller.Scale * controller.Scale);
+    controller.Scale = desiredScale;
+    controller.FramesSinceScaleChange = 0;
+
+    return controller.Scale;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+struct SResolutionScaleConfiguration {
+    // milliseconds the scene pass should take on the gpu
+    float TargetFrameTime;
+    float MinScale;
+    float MaxScale;
+};
+
+struct SResolutionScaleController {
+    SResolutionScaleConfiguration Configuration = {};
+    float Scale = 1.0f;
+    float SmoothedFrameTime = 0.0f;
+    uint32_t FramesSinceScaleChange = 0;
+};
+
+auto CreateResolutionScaleController(
+    const SResolutionScaleConfiguration& resolutionScaleConfiguration,
+    float initialScale) -> SResolutionScaleController;
+
+// Takes the measured gpu time of the last scene pass in milliseconds and returns the
+// scale to render the next one at. Pure, so it can be driven with synthetic timings.
+auto UpdateResolutionScale(SResolutionScaleController& resolutionScaleController, float gpuFrameTime) -> float;
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include "SpriteSort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <bit>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// three passes over 32 bit keys, one pass less than 8 bits and the histograms still fit in L1
+constexpr uint32_t g_radixBits = 11;
+constexpr uint32_t g_radixBucketCount = 1u << g_radixBits;
+constexpr uint32_t g_radixBucketMask = g_radixBucketCount - 1;
+constexpr uint32_t g_radixPassCount = (32 + g_radixBits - 1) / g_radixBits;
+
+using TRadixHistogram = std::array<uint32_t, g_radixBucketCount>;
+
+// Worker threads for large sorts. They are started on first use and sleep on WorkAvailable
+// between sorts, so a frame never pays for creating threads.
+struct SSortWorkerPool {
+    std::mutex Mutex;
+    std::condition_variable WorkAvailable;
+    std::condition_variable WorkDone;
+    std::vector<std::thread> Workers;
+    const std::function<void(size_t)>* Job = nullptr;
+    size_t JobThreadCount = 0;
+    size_t BusyWorkerCount = 0;
+    uint64_t JobGeneration = 0;
+    bool IsShuttingDown = false;
+
+    ~SSortWorkerPool() {
+
+        {
+            std::lock_guard lock(Mutex);
+            IsShuttingDown = true;
+        }
+        WorkAvailable.notify_all();
+
+        for (auto& worker : Workers) {
+            worker.join();
+        }
+    }
+};
+
+auto static RunSortWorker(SSortWorkerPool& workerPool, size_t workerIndex, uint64_t seenJobGeneration) -> void {
+
+    auto lock = std::unique_lock(workerPool.Mutex);
+    while (true) {
+
+        workerPool.WorkAvailable.wait(lock, [&] {
+            return workerPool.IsShuttingDown || workerPool.JobGeneration != seenJobGeneration;
+        });
+        if (workerPool.IsShuttingDown) {
+            return;
+        }
+
+        seenJobGeneration = workerPool.JobGeneration;
+        if (workerIndex >= workerPool.JobThreadCount) {
+            continue;
+        }
+
+        auto job = workerPool.Job;
+        lock.unlock();
+        (*job)(workerIndex);
+        lock.lock();
+
+        if (--workerPool.BusyWorkerCount == 0) {
+            workerPool.WorkDone.notify_one();
+        }
+    }
+}
+
+// Starts workers until threadCount slices can run at once, slice 0 always runs on the calling thread.
+// Expects the pool's mutex to be held.
+auto static EnsureSortWorkers(SSortWorkerPool& workerPool, size_t threadCount) -> void {
+
+    for (auto workerIndex = workerPool.Workers.size() + 1; workerIndex < threadCount; workerIndex++) {
+        // new workers must not mistake an already finished job for a new one
+        workerPool.Workers.emplace_back(RunSortWorker, std::ref(workerPool), workerIndex, workerPool.JobGeneration);
+    }
+}
+
+auto MakeSpriteSortKey(uint8_t layer, float y) -> uint32_t {
+
+    // flip the float so that its bits compare like the value does: negative numbers get
+    // all bits inverted, positive ones only the sign bit set
+    auto bits = std::bit_cast<uint32_t>(y);
+    auto orderedBits = (bits & 0x80000000u) != 0
+        ? ~bits
+        : bits | 0x80000000u;
+
+    return (static_cast<uint32_t>(layer) << 24) | (orderedBits >> 8);
+}
+
+auto static SortSpriteEntriesSerial(
+    TSpriteSortEntries& entries,
+    TSpriteSortEntries& scratch) -> void {
+
+    // with a single slice the digit counts don't depend on the order, so one read
+    // of the input counts all passes and every pass after that is only a scatter
+    std::array<TRadixHistogram, g_radixPassCount> histograms = {};
+    for (const auto& entry : entries) {
+        for (auto passIndex = 0u; passIndex < g_radixPassCount; passIndex++) {
+            histograms[passIndex][(entry.Key >> (passIndex * g_radixBits)) & g_radixBucketMask]++;
+        }
+    }
+
+    auto source = entries.data();
+    auto destination = scratch.data();
+    const auto entryCount = entries.size();
+
+    for (auto passIndex = 0u; passIndex < g_radixPassCount; passIndex++) {
+
+        const auto shift = passIndex * g_radixBits;
+        const auto& histogram = histograms[passIndex];
+
+        // all keys share this digit, the pass would only copy
+        if (std::ranges::find(histogram, entryCount) != histogram.end()) {
+            continue;
+        }
+
+        TRadixHistogram offset = {};
+        auto runningOffset = 0u;
+        for (auto bucketIndex = 0u; bucketIndex < g_radixBucketCount; bucketIndex++) {
+            offset[bucketIndex] = runningOffset;
+            runningOffset += histogram[bucketIndex];
+        }
+
+        for (auto entryIndex = 0u; entryIndex < entryCount; entryIndex++) {
+            const auto& entry = source[entryIndex];
+            destination[offset[(entry.Key >> shift) & g_radixBucketMask]++] = entry;
+        }
+
+        std::swap(source, destination);
+    }
+
+    if (source != entries.data()) {
+        entries.swap(scratch);
+    }
+}
+
+auto SortSpriteEntries(
+    TSpriteSortEntries& entries,
+    TSpriteSortEntries& scratch,
+    uint32_t maxThreadCount) -> void {
+
+    const auto entryCount = entries.size();
+    if (entryCount < 2) {
+        return;
+    }
+
+    scratch.resize(entryCount);
+
+    if (maxThreadCount == g_spriteSortAllHardwareThreads) {
+        maxThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    const auto threadCount = std::clamp<size_t>(entryCount / g_minEntriesPerSortThread, 1, maxThreadCount);
+    if (threadCount == 1) {
+        SortSpriteEntriesSerial(entries, scratch);
+        return;
+    }
+
+    // every thread owns a contiguous slice of the input and scatters it to offsets
+    // that come after all slices of lower threads with the same digit, which keeps the sort stable
+    std::vector<TRadixHistogram> histograms(threadCount);
+    std::vector<TRadixHistogram> offsets(threadCount);
+    std::barrier passBarrier(static_cast<std::ptrdiff_t>(threadCount));
+    auto isPassSkipped = false;
+    SSpriteSortEntry* sortedEntries = entries.data();
+
+    const std::function<void(size_t)> sortSlice = [&](size_t threadIndex) {
+
+        const auto sliceBegin = entryCount * threadIndex / threadCount;
+        const auto sliceEnd = entryCount * (threadIndex + 1) / threadCount;
+
+        auto source = entries.data();
+        auto destination = scratch.data();
+
+        for (auto passIndex = 0u; passIndex < g_radixPassCount; passIndex++) {
+
+            const auto shift = passIndex * g_radixBits;
+
+            TRadixHistogram histogram = {};
+            for (auto entryIndex = sliceBegin; entryIndex < sliceEnd; entryIndex++) {
+                histogram[(source[entryIndex].Key >> shift) & g_radixBucketMask]++;
+            }
+            histograms[threadIndex] = histogram;
+
+            passBarrier.arrive_and_wait();
+
+            if (threadIndex == 0) {
+                isPassSkipped = false;
+                auto offset = 0u;
+                for (auto bucketIndex = 0u; bucketIndex < g_radixBucketCount; bucketIndex++) {
+                    auto bucketCount = 0u;
+                    for (auto sliceIndex = 0u; sliceIndex < threadCount; sliceIndex++) {
+                        offsets[sliceIndex][bucketIndex] = offset;
+                        offset += histograms[sliceIndex][bucketIndex];
+                        bucketCount += histograms[sliceIndex][bucketIndex];
+                    }
+
+                    // all keys share this digit, the pass would only copy
+                    if (bucketCount == entryCount) {
+                        isPassSkipped = true;
+                    }
+                }
+            }
+
+            passBarrier.arrive_and_wait();
+
+            if (!isPassSkipped) {
+                // local copy, writes through destination could otherwise alias the shared offsets
+                auto offset = offsets[threadIndex];
+                for (auto entryIndex = sliceBegin; entryIndex < sliceEnd; entryIndex++) {
+                    const auto& entry = source[entryIndex];
+                    destination[offset[(entry.Key >> shift) & g_radixBucketMask]++] = entry;
+                }
+
+                std::swap(source, destination);
+            }
+
+            passBarrier.arrive_and_wait();
+        }
+
+        if (threadIndex == 0) {
+            sortedEntries = source;
+        }
+    };
+
+    static SSortWorkerPool workerPool;
+    {
+        std::lock_guard lock(workerPool.Mutex);
+        EnsureSortWorkers(workerPool, threadCount);
+        workerPool.Job = &sortSlice;
+        workerPool.JobThreadCount = threadCount;
+        workerPool.BusyWorkerCount = threadCount - 1;
+        workerPool.JobGeneration++;
+    }
+    workerPool.WorkAvailable.notify_all();
+
+    sortSlice(0);
+
+    {
+        auto lock = std::unique_lock(workerPool.Mutex);
+        workerPool.WorkDone.wait(lock, [&] {
+            return workerPool.BusyWorkerCount == 0;
+        });
+        workerPool.Job = nullptr;
+    }
+
+    if (sortedEntries != entries.data()) {
+        entries.swap(scratch);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "MemoryTelemetry.hpp"
+
+#include <cstdint>
+#include <vector>
+
+struct SSpriteSortEntry {
+    uint32_t Key;
+    uint32_t Index;
+};
+
+using TSpriteSortEntries = std::vector<SSpriteSortEntry, STrackingAllocator<SSpriteSortEntry, EMemorySubsystem::GpuStaging>>;
+
+// below this many entries per thread the sort stays on the calling thread
+constexpr size_t g_minEntriesPerSortThread = 16384;
+// maxThreadCount for SortSpriteEntries, one thread per hardware thread
+constexpr uint32_t g_spriteSortAllHardwareThreads = 0;
+
+// Layer in the top 8 bits, y in the lower 24, so sprites sort by layer first
+// and then top to bottom on screen within a layer.
+auto MakeSpriteSortKey(uint8_t layer, float y) -> uint32_t;
+
+// Stable LSD radix sort on Key, 11 bits per pass. Large inputs are split across up to maxThreadCount
+// threads, whose workers are started on first use and parked between sorts. scratch is resized
+// as needed and can be kept around between calls.
+auto SortSpriteEntries(
+    TSpriteSortEntries& entries,
+    TSpriteSortEntries& scratch,
+    uint32_t maxThreadCount) -> void;
\ No newline at end of file
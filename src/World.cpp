@@ -1,6 +1,8 @@
 #include "World.hpp"
 #include "Components.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <random>
 #include <ranges>
 
@@ -11,19 +13,28 @@
 
 SWorld g_world = {};
 
+// bodies store their entity offset by one, so entity 0 does not read as "no user data"
+auto static GetBodyUserData(entt::entity entity) -> uintptr_t {
+
+    return static_cast<uintptr_t>(entt::to_integral(entity)) + 1;
+}
+
+auto static GetBodyEntity(b2Body* body) -> entt::entity {
+
+    auto pointer = body->GetUserData().pointer;
+    return pointer != 0
+        ? static_cast<entt::entity>(pointer - 1)
+        : entt::null;
+}
+
 class Foo : public b2ContactListener {
 public:
     auto BeginContact(b2Contact* contact) -> void {
-        auto userData1 = contact->GetFixtureA()->GetBody()->GetUserData();
-        auto userData2 = contact->GetFixtureB()->GetBody()->GetUserData();
+        auto entity1 = GetBodyEntity(contact->GetFixtureA()->GetBody());
+        auto entity2 = GetBodyEntity(contact->GetFixtureB()->GetBody());
 
-
-        //auto entityId = static_cast<uint32_t>(g_world.PlayerEntity);
-        //bodyDefinition.userData.pointer = reinterpret_cast<uintptr_t>(&entityId);
-
-        if (userData1.pointer != 0 && userData2.pointer != 0) {
-            auto entity1 = reinterpret_cast<entt::entity>(static_cast<uint32_t>(userData1.pointer));
-            auto entity2 = reinterpret_cast<entt::entity>(static_cast<uint32_t>(userData2.pointer));
+        if (entity1 == entt::null || entity2 == entt::null) {
+            return;
         }
     }
 
@@ -37,107 +48,197 @@ Foo g_foo;
 b2ContactFilter g_playerVsEnemyContactFilter = {};
 b2ContactFilter g_enemyVsEnemyContactFilter = {};
 
-enum EMobileType : uint32_t {
-    Player = 1,
-    Enemy = 2,
-    Wall = 4,
-    Bullet = 8
-};
-
-struct SMobile {
-
-    b2Body* Body;
-    b2PolygonShape* Shape;
-    b2Filter ShapeFilter = {};
-};
-
-std::vector<SMobile> g_mobiles = {};
-
-auto AddMobile(
-    b2Vec2 position,
-    EMobileType mobileType,
-    uint32_t mobileTypeCollideAgainst,
-    float mass,
-    float size) -> void {
+auto CreateMobile(entt::entity entity, const SSpawnCommand& spawnCommand) -> void {
 
     b2BodyDef bodyDefinition = {};
-    bodyDefinition.position = position;
+    bodyDefinition.position = spawnCommand.Position;
     bodyDefinition.type = b2BodyType::b2_dynamicBody;
+    bodyDefinition.userData.pointer = GetBodyUserData(entity);
 
     b2PolygonShape shape;
-    shape.SetAsBox(size * 0.5f, size * 0.5f);
+    shape.SetAsBox(spawnCommand.Size * 0.5f, spawnCommand.Size * 0.5f);
 
     b2FixtureDef fixtureDefinition;
     fixtureDefinition.shape = &shape;
-    fixtureDefinition.density = mass;
+    fixtureDefinition.density = spawnCommand.Mass;
     fixtureDefinition.friction = 0.0f;
     fixtureDefinition.restitution = 0.0f;
     fixtureDefinition.filter.groupIndex = 0;    
-    fixtureDefinition.filter.categoryBits = mobileType;
-    fixtureDefinition.filter.maskBits = mobileTypeCollideAgainst;
+    fixtureDefinition.filter.categoryBits = spawnCommand.MobileType;
+    fixtureDefinition.filter.maskBits = spawnCommand.MobileTypeCollideAgainst;
 
     auto body = g_world.PhysicsWorld.CreateBody(&bodyDefinition);
     body->CreateFixture(&fixtureDefinition);
 
-    auto mobile = SMobile{
-        .Body = body,
-    };
+    auto& registry = g_world.EntityRegistry;
+    registry.emplace<SPhysicsComponent>(entity, body);
+    registry.emplace<SPositionComponent>(entity, spawnCommand.Position);
+
+    if (spawnCommand.MobileType == EMobileType::Player) {
+
+        g_world.PlayerEntity = entity;
+        registry.emplace<SPlayerComponent>(entity);
+        registry.emplace<SColorComponent>(entity, glm::vec4{0.0f, 1.0f, 0.0f, 1.0f});
+        registry.emplace<SSpriteLayerComponent>(entity, uint8_t{1});
+
+    } else if (spawnCommand.MobileType == EMobileType::Enemy) {
+
+        registry.emplace<SEnemyComponent>(entity, 100.0f);
+        registry.emplace<SColorComponent>(entity, glm::vec4{1.0f, 0.0f, 0.0f, 1.0f});
+        registry.emplace<SSpriteLayerComponent>(entity, uint8_t{0});
+    }
+
+    // the player centers the activation area and stays simulated, it is not binned
+    if (spawnCommand.MobileType != EMobileType::Player) {
+        AddToWorldChunk(entity, body);
+    }
+}
+
+auto EnqueueSpawn(const SSpawnCommand& spawnCommand) -> void {
+
+    g_world.Commands.Spawns.push_back(spawnCommand);
+}
+
+auto EnqueueDespawn(entt::entity entity) -> void {
+
+    g_world.Commands.Despawns.push_back(entity);
+}
+
+auto FlushWorldCommands() -> void {
+
+    auto& registry = g_world.EntityRegistry;
+    auto& commands = g_world.Commands;
 
-    g_mobiles.push_back(mobile);
+    // component changes go first so they can't resurrect anything despawned below,
+    // the stable sort keeps the order of changes to the same entity
+    if (!commands.ComponentChanges.empty()) {
+        std::ranges::stable_sort(commands.ComponentChanges, {}, &SComponentCommand::Entity);
+        for (auto& componentCommand : commands.ComponentChanges) {
+            if (registry.valid(componentCommand.Entity)) {
+                componentCommand.Apply(registry, componentCommand.Entity);
+            }
+        }
+        commands.ComponentChanges.clear();
+    }
+
+    if (!commands.Despawns.empty()) {
+        std::ranges::sort(commands.Despawns);
+        auto [duplicatesBegin, duplicatesEnd] = std::ranges::unique(commands.Despawns);
+        commands.Despawns.erase(duplicatesBegin, duplicatesEnd);
+        std::erase_if(commands.Despawns, [&](entt::entity entity) {
+            return !registry.valid(entity);
+        });
+
+        for (auto entity : commands.Despawns) {
+            RemoveFromWorldChunk(entity);
+            if (auto physicsComponent = registry.try_get<SPhysicsComponent>(entity)) {
+                g_world.PhysicsWorld.DestroyBody(physicsComponent->Body);
+            }
+            if (entity == g_world.PlayerEntity) {
+                g_world.PlayerEntity = entt::null;
+            }
+        }
 
-    if (mobileType == EMobileType::Player) {
+        registry.destroy(commands.Despawns.begin(), commands.Despawns.end());
+        commands.Despawns.clear();
+    }
 
-        g_world.PlayerEntity = g_world.EntityRegistry.create();
-        g_world.EntityRegistry.emplace<SPhysicsComponent>(g_world.PlayerEntity, body);
-        g_world.EntityRegistry.emplace<SPlayerComponent>(g_world.PlayerEntity);
-        g_world.EntityRegistry.emplace<SPositionComponent>(g_world.PlayerEntity, position);
-        g_world.EntityRegistry.emplace<SColorComponent>(g_world.PlayerEntity, glm::vec4{0.0f, 1.0f, 0.0f, 1.0f});
+    if (!commands.Spawns.empty()) {
+        // grouped by type, so a wave of enemies fills each storage in one go
+        std::ranges::stable_sort(commands.Spawns, {}, &SSpawnCommand::MobileType);
 
-        auto entityId = static_cast<uint32_t>(g_world.PlayerEntity);
-        bodyDefinition.userData.pointer = reinterpret_cast<uintptr_t>(&entityId);
+        const auto spawnCount = commands.Spawns.size();
+        registry.storage<SPhysicsComponent>().reserve(registry.storage<SPhysicsComponent>().size() + spawnCount);
+        registry.storage<SPositionComponent>().reserve(registry.storage<SPositionComponent>().size() + spawnCount);
+        registry.storage<SColorComponent>().reserve(registry.storage<SColorComponent>().size() + spawnCount);
+        registry.storage<SSpriteLayerComponent>().reserve(registry.storage<SSpriteLayerComponent>().size() + spawnCount);
 
-    } else if (mobileType == EMobileType::Enemy) {
+        commands.SpawnedEntities.resize(spawnCount);
+        registry.create(commands.SpawnedEntities.begin(), commands.SpawnedEntities.end());
 
-        auto enemy = g_world.EntityRegistry.create();
-        auto enemyId = static_cast<uint32_t>(enemy);
-        g_world.EntityRegistry.emplace<SPhysicsComponent>(enemy, body);
-        g_world.EntityRegistry.emplace<SEnemyComponent>(enemy, 100.0f);
-        g_world.EntityRegistry.emplace<SPositionComponent>(enemy, position);
-        g_world.EntityRegistry.emplace<SColorComponent>(enemy, glm::vec4{1.0f, 0.0f, 0.0f, 1.0f});
+        for (auto spawnIndex = 0u; spawnIndex < spawnCount; spawnIndex++) {
+            CreateMobile(commands.SpawnedEntities[spawnIndex], commands.Spawns[spawnIndex]);
+        }
 
-        auto entityId = static_cast<uint32_t>(enemy);
-        bodyDefinition.userData.pointer = reinterpret_cast<uintptr_t>(&entityId);        
+        commands.Spawns.clear();
+        commands.SpawnedEntities.clear();
     }
 }
 
-auto InitializeLevel() -> void {
+auto InitializeLevel(uint32_t seed) -> void {
 
-    AddMobile({0, 0}, EMobileType::Player, EMobileType::Enemy | EMobileType::Wall, 10000.0f, 32.0f);
+    EnqueueSpawn({
+        .Position = {0, 0},
+        .MobileType = EMobileType::Player,
+        .MobileTypeCollideAgainst = EMobileType::Enemy | EMobileType::Wall,
+        .Mass = 10000.0f,
+        .Size = 32.0f
+    });
 
-    std::random_device seeder;
-    std::mt19937 engine(seeder());
+    std::mt19937 engine(seed);
     std::uniform_real_distribution<float> dist(0, 800);
 
     const auto enemyIndices = std::ranges::iota_view{0, 400};
     for(auto enemyIndex : enemyIndices) {
 
         auto enemyPosition = b2Vec2(-800.0f + dist(engine), -800.0f + dist(engine));
-        AddMobile(enemyPosition, EMobileType::Enemy, EMobileType::Enemy | EMobileType::Player | EMobileType::Wall, 10.0f, 32.0f);
+        EnqueueSpawn({
+            .Position = enemyPosition,
+            .MobileType = EMobileType::Enemy,
+            .MobileTypeCollideAgainst = EMobileType::Enemy | EMobileType::Player | EMobileType::Wall,
+            .Mass = 10.0f,
+            .Size = 32.0f
+        });
     }
+
+    FlushWorldCommands();
 }
 
-auto InitializeWorld() -> void {
+auto InitializeWorld(uint32_t seed) -> void {
 
+    g_world.Seed = seed;
     g_world.PhysicsWorld.SetContactListener(&g_foo);
     
-    InitializeLevel();
+    InitializeLevel(seed);
 }
 
 auto ShutdownWorld() -> void {
 
-    for (auto& mobile : g_mobiles) {
-        g_world.PhysicsWorld.DestroyBody(mobile.Body);
-    }
+    g_world.Commands = {};
+
+    auto physicsView = g_world.EntityRegistry.view<SPhysicsComponent>();
+    physicsView.each([](auto& physicsComponent) {
+        g_world.PhysicsWorld.DestroyBody(physicsComponent.Body);
+    });
 
     g_world.EntityRegistry.clear();
+    g_world.Chunks = {};
+}
+
+auto static HashFloat(uint32_t hash, float value) -> uint32_t {
+
+    // FNV-1a over the raw bits, a replay has to match bit for bit anyway
+    auto bits = std::bit_cast<uint32_t>(value);
+    for (auto byteIndex = 0; byteIndex < 4; byteIndex++) {
+        hash ^= (bits >> (byteIndex * 8)) & 0xffu;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+auto ComputeWorldChecksum(const TEntityRegistry& registry) -> uint32_t {
+
+    auto hash = 2166136261u;
+    auto physicsView = registry.view<SPhysicsComponent>();
+    physicsView.each([&](const auto& physicsComponent) {
+
+        const auto& position = physicsComponent.Body->GetPosition();
+        const auto& velocity = physicsComponent.Body->GetLinearVelocity();
+        hash = HashFloat(hash, position.x);
+        hash = HashFloat(hash, position.y);
+        hash = HashFloat(hash, velocity.x);
+        hash = HashFloat(hash, velocity.y);
+    });
+
+    return hash;
 }
\ No newline at end of file
@@ -3,14 +3,85 @@
 #include <entt/entt.hpp>
 #include "b2_user_settings.h"
 #include <box2d/box2d.h>
+#include "MemoryTelemetry.hpp"
+#include "WorldChunks.hpp"
+
+#include <functional>
+#include <vector>
+
+using TEntityRegistry = entt::basic_registry<entt::entity, STrackingAllocator<entt::entity, EMemorySubsystem::EnTT>>;
+
+enum EMobileType : uint32_t {
+    Player = 1,
+    Enemy = 2,
+    Wall = 4,
+    Bullet = 8
+};
+
+struct SSpawnCommand {
+    b2Vec2 Position;
+    EMobileType MobileType;
+    uint32_t MobileTypeCollideAgainst;
+    float Mass;
+    float Size;
+};
+
+struct SComponentCommand {
+    entt::entity Entity;
+    std::function<void(TEntityRegistry&, entt::entity)> Apply;
+};
+
+// Structural changes requested while a tick is running. Nothing touches the registry
+// or the physics world until FlushWorldCommands, so systems iterating views and
+// the contact listener can spawn and despawn freely.
+struct SWorldCommandBuffer {
+    std::vector<SSpawnCommand> Spawns;
+    std::vector<entt::entity> Despawns;
+    std::vector<SComponentCommand> ComponentChanges;
+    std::vector<entt::entity> SpawnedEntities;
+};
 
 struct SWorld {
-    entt::registry EntityRegistry = {};
+    TEntityRegistry EntityRegistry = {};
     entt::entity PlayerEntity;
+    uint32_t Seed;
     b2World PhysicsWorld = b2World({0.0f, 0.0f});
+    SWorldCommandBuffer Commands = {};
+    SWorldChunks Chunks = {};
 };
 
 extern SWorld g_world;
 
-auto InitializeWorld() -> void;
-auto ShutdownWorld() -> void;
\ No newline at end of file
+auto InitializeWorld(uint32_t seed) -> void;
+auto ShutdownWorld() -> void;
+
+auto ComputeWorldChecksum(const TEntityRegistry& registry) -> uint32_t;
+
+auto EnqueueSpawn(const SSpawnCommand& spawnCommand) -> void;
+auto EnqueueDespawn(entt::entity entity) -> void;
+
+template<typename TComponent>
+auto EnqueueComponentChange(entt::entity entity, TComponent component) -> void {
+
+    g_world.Commands.ComponentChanges.push_back({
+        .Entity = entity,
+        .Apply = [component = std::move(component)](TEntityRegistry& registry, entt::entity target) {
+            registry.emplace_or_replace<TComponent>(target, component);
+        }
+    });
+}
+
+template<typename TComponent>
+auto EnqueueComponentRemoval(entt::entity entity) -> void {
+
+    g_world.Commands.ComponentChanges.push_back({
+        .Entity = entity,
+        .Apply = [](TEntityRegistry& registry, entt::entity target) {
+            registry.remove<TComponent>(target);
+        }
+    });
+}
+
+// The sync point, applies everything enqueued since the last flush. Call it between
+// physics steps, never from inside one.
+auto FlushWorldCommands() -> void;
\ No newline at end of file
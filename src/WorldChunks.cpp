@@ -0,0 +1,273 @@
+#include "WorldChunks.hpp"
+#include "Components.hpp"
+#include "World.hpp"
+
+#include <spdlog/spdlog.h>
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+auto static GetChunkKey(glm::ivec2 chunkCoordinate) -> uint64_t {
+
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkCoordinate.x)) << 32) |
+        static_cast<uint64_t>(static_cast<uint32_t>(chunkCoordinate.y));
+}
+
+auto static GetChunkCoordinate(b2Vec2 position) -> glm::ivec2 {
+
+    const auto chunkSize = g_world.Chunks.Configuration.ChunkSize;
+    return glm::ivec2{
+        static_cast<int32_t>(std::floor(position.x / chunkSize)),
+        static_cast<int32_t>(std::floor(position.y / chunkSize))
+    };
+}
+
+auto static IsInActivationRadius(glm::ivec2 chunkCoordinate) -> bool {
+
+    const auto& chunks = g_world.Chunks;
+    auto distance = glm::abs(chunkCoordinate - chunks.CenterChunkCoordinate);
+    return std::max(distance.x, distance.y) <= chunks.Configuration.ActivationRadius;
+}
+
+auto static QueueChunkTransition(uint64_t chunkKey, SWorldChunk& chunk, bool isTargetActive) -> void {
+
+    // restarting from the front is cheap, SetEnabled returns early for bodies already in that state
+    chunk.IsTargetActive = isTargetActive;
+    chunk.TransitionCursor = 0;
+    if (!chunk.IsTransitionQueued) {
+        chunk.IsTransitionQueued = true;
+        g_world.Chunks.PendingTransitions.push_back(chunkKey);
+    }
+}
+
+auto static UpdateTargetActive(uint64_t chunkKey, SWorldChunk& chunk) -> void {
+
+    auto isTargetActive = IsInActivationRadius(chunk.Coordinate);
+    if (isTargetActive != chunk.IsTargetActive) {
+        QueueChunkTransition(chunkKey, chunk, isTargetActive);
+    }
+}
+
+auto static GetOrCreateChunk(glm::ivec2 chunkCoordinate) -> SWorldChunk& {
+
+    auto [chunkIterator, isInserted] = g_world.Chunks.Chunks.try_emplace(GetChunkKey(chunkCoordinate));
+    auto& chunk = chunkIterator->second;
+    if (isInserted) {
+        chunk.Coordinate = chunkCoordinate;
+        chunk.IsActive = IsInActivationRadius(chunkCoordinate);
+        chunk.IsTargetActive = chunk.IsActive;
+    }
+
+    return chunk;
+}
+
+// Chunks are created on demand wherever bodies go, drop the ones nothing needs anymore
+// so the map stays as large as the populated area
+auto static EraseChunkIfUnused(uint64_t chunkKey, const SWorldChunk& chunk) -> void {
+
+    if (chunk.Entities.empty() && !chunk.IsActive && !chunk.IsTargetActive && !chunk.IsTransitionQueued) {
+        g_world.Chunks.Chunks.erase(chunkKey);
+    }
+}
+
+auto static SwapChunkEntities(SWorldChunk& chunk, uint32_t entityIndex, uint32_t otherEntityIndex) -> void {
+
+    auto& registry = g_world.EntityRegistry;
+    std::swap(chunk.Entities[entityIndex], chunk.Entities[otherEntityIndex]);
+    registry.get<SChunkComponent>(chunk.Entities[entityIndex]).EntityIndex = entityIndex;
+    registry.get<SChunkComponent>(chunk.Entities[otherEntityIndex]).EntityIndex = otherEntityIndex;
+}
+
+auto static RemoveFromChunk(SWorldChunk& chunk, uint32_t entityIndex) -> void {
+
+    // swap and pop, but keep the already transitioned prefix intact
+    if (entityIndex < chunk.TransitionCursor) {
+        chunk.TransitionCursor--;
+        SwapChunkEntities(chunk, entityIndex, chunk.TransitionCursor);
+        entityIndex = chunk.TransitionCursor;
+    }
+
+    SwapChunkEntities(chunk, entityIndex, static_cast<uint32_t>(chunk.Entities.size() - 1));
+    chunk.Entities.pop_back();
+}
+
+auto static AddToChunk(SWorldChunk& chunk, entt::entity entity, SChunkComponent& chunkComponent) -> void {
+
+    chunkComponent.Coordinate = chunk.Coordinate;
+    chunkComponent.EntityIndex = static_cast<uint32_t>(chunk.Entities.size());
+    chunk.Entities.push_back(entity);
+}
+
+auto AddToWorldChunk(entt::entity entity, b2Body* body) -> void {
+
+    auto& chunk = GetOrCreateChunk(GetChunkCoordinate(body->GetPosition()));
+    AddToChunk(chunk, entity, g_world.EntityRegistry.emplace<SChunkComponent>(entity));
+
+    if (!chunk.IsActive) {
+        body->SetEnabled(false);
+    }
+}
+
+auto RemoveFromWorldChunk(entt::entity entity) -> void {
+
+    auto chunkComponent = g_world.EntityRegistry.try_get<SChunkComponent>(entity);
+    if (chunkComponent == nullptr) {
+        return;
+    }
+
+    auto chunkKey = GetChunkKey(chunkComponent->Coordinate);
+    auto& chunk = g_world.Chunks.Chunks.at(chunkKey);
+    RemoveFromChunk(chunk, chunkComponent->EntityIndex);
+    EraseChunkIfUnused(chunkKey, chunk);
+}
+
+auto static CollectMovedEntities(const SWorldChunk& chunk) -> void {
+
+    auto& registry = g_world.EntityRegistry;
+    for (auto entity : chunk.Entities) {
+
+        auto body = registry.get<SPhysicsComponent>(entity).Body;
+        if (!body->IsEnabled()) {
+            continue;
+        }
+
+        if (GetChunkCoordinate(body->GetPosition()) != registry.get<SChunkComponent>(entity).Coordinate) {
+            g_world.Chunks.MovedEntities.push_back(entity);
+        }
+    }
+}
+
+auto UpdateWorldChunks(b2Vec2 playerPosition) -> void {
+
+    auto& chunks = g_world.Chunks;
+    auto& registry = g_world.EntityRegistry;
+
+    // disabled bodies don't move, so only chunks which still have enabled bodies are walked:
+    // the ones within the activation radius and the ones still being deactivated
+    chunks.MovedEntities.clear();
+    const auto activationRadius = chunks.Configuration.ActivationRadius;
+    for (auto y = -activationRadius; y <= activationRadius; y++) {
+        for (auto x = -activationRadius; x <= activationRadius; x++) {
+            auto chunkIterator = chunks.Chunks.find(GetChunkKey(chunks.CenterChunkCoordinate + glm::ivec2{x, y}));
+            if (chunkIterator != chunks.Chunks.end()) {
+                CollectMovedEntities(chunkIterator->second);
+            }
+        }
+    }
+    for (auto chunkKey : chunks.PendingTransitions) {
+        const auto& chunk = chunks.Chunks.at(chunkKey);
+        if (!chunk.IsTargetActive) {
+            CollectMovedEntities(chunk);
+        }
+    }
+
+    for (auto entity : chunks.MovedEntities) {
+
+        auto& chunkComponent = registry.get<SChunkComponent>(entity);
+        auto body = registry.get<SPhysicsComponent>(entity).Body;
+
+        auto previousChunkKey = GetChunkKey(chunkComponent.Coordinate);
+        auto& previousChunk = chunks.Chunks.at(previousChunkKey);
+        RemoveFromChunk(previousChunk, chunkComponent.EntityIndex);
+        EraseChunkIfUnused(previousChunkKey, previousChunk);
+
+        auto& chunk = GetOrCreateChunk(GetChunkCoordinate(body->GetPosition()));
+        AddToChunk(chunk, entity, chunkComponent);
+
+        // entities past the cursor of a pending transition still carry the chunk's current state,
+        // the transition picks this one up when it gets there
+        if (!chunk.IsActive) {
+            body->SetEnabled(false);
+        }
+    }
+
+    // only chunks in the old or the new activation area can change their target,
+    // everything else was and stays inactive
+    auto centerChunkCoordinate = GetChunkCoordinate(playerPosition);
+    if (centerChunkCoordinate != chunks.CenterChunkCoordinate) {
+        auto previousCenterChunkCoordinate = chunks.CenterChunkCoordinate;
+        chunks.CenterChunkCoordinate = centerChunkCoordinate;
+
+        for (auto y = -activationRadius; y <= activationRadius; y++) {
+            for (auto x = -activationRadius; x <= activationRadius; x++) {
+                auto chunkIterator = chunks.Chunks.find(GetChunkKey(centerChunkCoordinate + glm::ivec2{x, y}));
+                if (chunkIterator != chunks.Chunks.end()) {
+                    UpdateTargetActive(chunkIterator->first, chunkIterator->second);
+                }
+            }
+        }
+
+        for (auto y = -activationRadius; y <= activationRadius; y++) {
+            for (auto x = -activationRadius; x <= activationRadius; x++) {
+                auto chunkCoordinate = previousCenterChunkCoordinate + glm::ivec2{x, y};
+                if (IsInActivationRadius(chunkCoordinate)) {
+                    continue;
+                }
+
+                auto chunkIterator = chunks.Chunks.find(GetChunkKey(chunkCoordinate));
+                if (chunkIterator != chunks.Chunks.end()) {
+                    UpdateTargetActive(chunkIterator->first, chunkIterator->second);
+                }
+            }
+        }
+    }
+
+    auto transitionBudget = chunks.Configuration.MaxBodyTransitionsPerUpdate;
+    while (transitionBudget > 0 && !chunks.PendingTransitions.empty()) {
+
+        auto& chunk = chunks.Chunks.at(chunks.PendingTransitions.front());
+        while (transitionBudget > 0 && chunk.TransitionCursor < chunk.Entities.size()) {
+            auto entity = chunk.Entities[chunk.TransitionCursor];
+            registry.get<SPhysicsComponent>(entity).Body->SetEnabled(chunk.IsTargetActive);
+            chunk.TransitionCursor++;
+            transitionBudget--;
+        }
+
+        if (chunk.TransitionCursor < chunk.Entities.size()) {
+            break;
+        }
+
+        chunk.IsActive = chunk.IsTargetActive;
+        chunk.IsTransitionQueued = false;
+        chunk.TransitionCursor = 0;
+        EraseChunkIfUnused(chunks.PendingTransitions.front(), chunk);
+        chunks.PendingTransitions.pop_front();
+    }
+}
+
+auto GetWorldChunkStatistics() -> SWorldChunkStatistics {
+
+    SWorldChunkStatistics statistics = {};
+    for (const auto& [chunkKey, chunk] : g_world.Chunks.Chunks) {
+        if (chunk.IsActive) {
+            statistics.ActiveChunkCount++;
+        } else {
+            statistics.InactiveChunkCount++;
+        }
+    }
+
+    auto physicsView = g_world.EntityRegistry.view<SPhysicsComponent, SChunkComponent>();
+    physicsView.each([&](const auto& physicsComponent, [[maybe_unused]] const auto& chunkComponent) {
+        if (physicsComponent.Body->IsEnabled()) {
+            statistics.ActiveBodyCount++;
+        } else {
+            statistics.InactiveBodyCount++;
+        }
+    });
+
+    statistics.PendingChunkTransitionCount = static_cast<uint32_t>(g_world.Chunks.PendingTransitions.size());
+    return statistics;
+}
+
+auto LogWorldChunkStatistics() -> void {
+
+    auto statistics = GetWorldChunkStatistics();
+    spdlog::info("{} {} active / {} inactive chunks, {} active / {} inactive bodies, {} chunk transitions pending",
+        "WorldChunks",
+        statistics.ActiveChunkCount,
+        statistics.InactiveChunkCount,
+        statistics.ActiveBodyCount,
+        statistics.InactiveBodyCount,
+        statistics.PendingChunkTransitionCount);
+}
\ No newline at end of file
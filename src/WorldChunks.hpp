@@ -0,0 +1,61 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include "b2_user_settings.h"
+#include <box2d/box2d.h>
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+struct SWorldChunkConfiguration {
+    float ChunkSize;
+    // in chunks, chunks within this chebyshev distance of the player's chunk stay simulated
+    int32_t ActivationRadius;
+    // bodies enabled or disabled per update, larger moves across the map are spread over several updates
+    uint32_t MaxBodyTransitionsPerUpdate;
+};
+
+struct SWorldChunk {
+    glm::ivec2 Coordinate;
+    std::vector<entt::entity> Entities;
+    bool IsActive;
+    bool IsTargetActive;
+    bool IsTransitionQueued;
+    // entities before this index already match IsTargetActive
+    uint32_t TransitionCursor;
+};
+
+struct SWorldChunkStatistics {
+    uint32_t ActiveChunkCount;
+    uint32_t InactiveChunkCount;
+    uint32_t ActiveBodyCount;
+    uint32_t InactiveBodyCount;
+    uint32_t PendingChunkTransitionCount;
+};
+
+struct SWorldChunks {
+    SWorldChunkConfiguration Configuration = {
+        .ChunkSize = 512.0f,
+        .ActivationRadius = 2,
+        .MaxBodyTransitionsPerUpdate = 256,
+    };
+    std::unordered_map<uint64_t, SWorldChunk> Chunks;
+    std::deque<uint64_t> PendingTransitions;
+    glm::ivec2 CenterChunkCoordinate = {};
+    // entities which crossed a chunk border this update, kept to reuse its storage
+    std::vector<entt::entity> MovedEntities;
+};
+
+auto AddToWorldChunk(entt::entity entity, b2Body* body) -> void;
+auto RemoveFromWorldChunk(entt::entity entity) -> void;
+
+// The player is never binned, so it can not park itself by walking out of the activation radius.
+// Moves bodies that crossed a chunk border, re-centers the activation area on the player
+// and works off pending chunk transitions within the per update budget. Call between physics steps.
+auto UpdateWorldChunks(b2Vec2 playerPosition) -> void;
+
+auto GetWorldChunkStatistics() -> SWorldChunkStatistics;
+auto LogWorldChunkStatistics() -> void;
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+// Picked up by box2d/b2_settings.h when B2_USER_SETTINGS is defined (BOX2D_USER_SETTINGS in lib/CMakeLists.txt).
+// Mirrors the defaults of b2_settings.h, except that memory goes through our telemetry.
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#include <box2d/b2_types.h>
+#include <box2d/b2_api.h>
+
+#define b2_lengthUnitsPerMeter 1.0f
+#define b2_maxPolygonVertices 8
+
+struct B2_API b2BodyUserData {
+    b2BodyUserData() {
+        pointer = 0;
+    }
+
+    uintptr_t pointer;
+};
+
+struct B2_API b2FixtureUserData {
+    b2FixtureUserData() {
+        pointer = 0;
+    }
+
+    uintptr_t pointer;
+};
+
+struct B2_API b2JointUserData {
+    b2JointUserData() {
+        pointer = 0;
+    }
+
+    uintptr_t pointer;
+};
+
+// Implemented in Box2DAllocator.cpp, accounted to EMemorySubsystem::Box2D
+auto AllocateBox2DMemory(int32 size) -> void*;
+auto FreeBox2DMemory(void* memory) -> void;
+
+inline void* b2Alloc(int32 size) {
+    return AllocateBox2DMemory(size);
+}
+
+inline void b2Free(void* memory) {
+    FreeBox2DMemory(memory);
+}
+
+B2_API void b2Log_Default(const char* string, va_list args);
+
+inline void b2Log(const char* string, ...) {
+    va_list args;
+    va_start(args, string);
+    b2Log_Default(string, args);
+    va_end(args);
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "ResolutionScaler.hpp"
+#include "TestCheck.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cmath>
+
+constexpr float g_targetFrameTime = 12.0f;
+
+auto static CreateTestController(float initialScale) -> SResolutionScaleController {
+
+    return CreateResolutionScaleController(SResolutionScaleConfiguration{
+        .TargetFrameTime = g_targetFrameTime,
+        .MinScale = 0.5f,
+        .MaxScale = 1.0f,
+    }, initialScale);
+}
+
+// feeds a synthetic gpu load which costs fullScaleFrameTime at scale 1 and grows with the pixel count
+auto static RunFrames(SResolutionScaleController& controller, float fullScaleFrameTime, int32_t frameCount) -> float {
+
+    for (auto frameIndex = 0; frameIndex < frameCount; frameIndex++) {
+        UpdateResolutionScale(controller, fullScaleFrameTime * controller.Scale * controller.Scale);
+    }
+
+    return controller.Scale;
+}
+
+auto static CheckConvergence() -> void {
+
+    auto controller = CreateTestController(1.0f);
+
+    auto scale = RunFrames(controller, 20.0f, 600);
+    Check(scale > 0.75f && scale < 0.80f, fmt::format("20ms at scale 1 settles near sqrt(12/20), got {}", scale));
+    Check(std::abs(20.0f * scale * scale - g_targetFrameTime) < g_targetFrameTime * 0.1f, "settled cost is within 10% of the target");
+
+    auto settledScale = scale;
+    scale = RunFrames(controller, 20.0f, 300);
+    Check(scale == settledScale, "scale stays put once settled");
+
+    scale = RunFrames(controller, 6.0f, 600);
+    Check(scale == 1.0f, fmt::format("a 6ms load returns to scale 1, got {}", scale));
+}
+
+auto static CheckScaleLimits() -> void {
+
+    auto controller = CreateTestController(1.0f);
+
+    auto lowestScale = 1.0f;
+    for (auto frameIndex = 0; frameIndex < 600; frameIndex++) {
+        lowestScale = std::min(lowestScale, UpdateResolutionScale(controller, 200.0f * controller.Scale * controller.Scale));
+    }
+    Check(lowestScale == 0.5f && controller.Scale == 0.5f, "a load far over the target clamps at MinScale");
+
+    auto highestScale = 0.0f;
+    for (auto frameIndex = 0; frameIndex < 600; frameIndex++) {
+        highestScale = std::max(highestScale, UpdateResolutionScale(controller, 0.5f * controller.Scale * controller.Scale));
+    }
+    Check(highestScale == 1.0f && controller.Scale == 1.0f, "a load far under the target clamps at MaxScale");
+
+    auto clampedController = CreateTestController(4.0f);
+    Check(clampedController.Scale == 1.0f, "the initial scale is clamped into the configured range");
+}
+
+auto static CheckCooldown() -> void {
+
+    auto controller = CreateTestController(1.0f);
+
+    auto framesUntilChange = 0;
+    while (UpdateResolutionScale(controller, 40.0f * controller.Scale * controller.Scale) == 1.0f && framesUntilChange < 100) {
+        framesUntilChange++;
+    }
+    Check(framesUntilChange == 14, fmt::format("the first change waits out the cooldown, changed after {} frames", framesUntilChange));
+
+    auto changedScale = controller.Scale;
+    auto isUnchangedDuringCooldown = true;
+    for (auto frameIndex = 0; frameIndex < 14; frameIndex++) {
+        isUnchangedDuringCooldown &= UpdateResolutionScale(controller, 40.0f * controller.Scale * controller.Scale) == changedScale;
+    }
+    Check(isUnchangedDuringCooldown, "no change within the cooldown after a change");
+
+    UpdateResolutionScale(controller, 40.0f * controller.Scale * controller.Scale);
+    Check(controller.Scale != changedScale, "the next change happens right after the cooldown");
+}
+
+auto static CheckDisabledTarget() -> void {
+
+    auto controller = CreateResolutionScaleController(SResolutionScaleConfiguration{
+        .TargetFrameTime = 0.0f,
+        .MinScale = 0.5f,
+        .MaxScale = 1.0f,
+    }, 0.75f);
+
+    auto scale = RunFrames(controller, 50.0f, 300);
+    Check(scale == 0.75f, "a TargetFrameTime of 0 keeps the scale fixed under load");
+
+    scale = RunFrames(controller, 1.0f, 300);
+    Check(scale == 0.75f, "a TargetFrameTime of 0 keeps the scale fixed when idle");
+}
+
+int32_t main() {
+
+    CheckConvergence();
+    CheckScaleLimits();
+    CheckCooldown();
+    CheckDisabledTarget();
+
+    return FinishChecks("ResolutionScalerTests");
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "SpriteSort.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+constexpr size_t g_benchmarkEntryCount = 100000;
+constexpr int32_t g_benchmarkIterationCount = 200;
+
+auto static RunBenchmark(const TSpriteSortEntries& unsortedEntries, uint32_t maxThreadCount) -> void {
+
+    TSpriteSortEntries entries;
+    TSpriteSortEntries scratch;
+    std::vector<double> sortDurations;
+    sortDurations.reserve(g_benchmarkIterationCount);
+
+    for (auto iterationIndex = 0; iterationIndex < g_benchmarkIterationCount; iterationIndex++) {
+        entries = unsortedEntries;
+
+        auto sortStartTime = std::chrono::steady_clock::now();
+        SortSpriteEntries(entries, scratch, maxThreadCount);
+        auto sortEndTime = std::chrono::steady_clock::now();
+
+        sortDurations.push_back(std::chrono::duration<double, std::milli>(sortEndTime - sortStartTime).count());
+    }
+
+    std::ranges::sort(sortDurations);
+    spdlog::info("{} {} entries on up to {} threads, sort ms min {:.3f} p50 {:.3f} p95 {:.3f} max {:.3f}",
+        "SpriteSortBenchmark",
+        unsortedEntries.size(),
+        maxThreadCount,
+        sortDurations.front(),
+        sortDurations[sortDurations.size() / 2],
+        sortDurations[sortDurations.size() * 95 / 100],
+        sortDurations.back());
+}
+
+int32_t main() {
+
+    std::mt19937 engine(1);
+    std::uniform_int_distribution<uint32_t> layerDistribution(0, 3);
+    std::uniform_real_distribution<float> yDistribution(-5000.0f, 5000.0f);
+
+    TSpriteSortEntries unsortedEntries(g_benchmarkEntryCount);
+    for (auto entryIndex = 0u; entryIndex < g_benchmarkEntryCount; entryIndex++) {
+        unsortedEntries[entryIndex] = {
+            .Key = MakeSpriteSortKey(static_cast<uint8_t>(layerDistribution(engine)), yDistribution(engine)),
+            .Index = entryIndex
+        };
+    }
+
+    spdlog::info("{} {} hardware threads", "SpriteSortBenchmark", std::thread::hardware_concurrency());
+    for (auto maxThreadCount : { 1u, 2u, 4u }) {
+        RunBenchmark(unsortedEntries, maxThreadCount);
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "SpriteSort.hpp"
+#include "TestCheck.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+auto static MakeRandomEntries(size_t entryCount, uint32_t seed) -> TSpriteSortEntries {
+
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<uint32_t> layerDistribution(0, 3);
+    std::uniform_real_distribution<float> yDistribution(-5000.0f, 5000.0f);
+
+    TSpriteSortEntries entries(entryCount);
+    for (auto entryIndex = 0u; entryIndex < entryCount; entryIndex++) {
+        // coarse y values so plenty of keys tie and stability actually gets exercised
+        auto y = std::round(yDistribution(engine) / 64.0f) * 64.0f;
+        entries[entryIndex] = {
+            .Key = MakeSpriteSortKey(static_cast<uint8_t>(layerDistribution(engine)), y),
+            .Index = entryIndex
+        };
+    }
+
+    return entries;
+}
+
+auto static CheckSortMatchesStableSort(size_t entryCount, uint32_t maxThreadCount) -> void {
+
+    auto entries = MakeRandomEntries(entryCount, static_cast<uint32_t>(entryCount));
+    auto expectedEntries = entries;
+    std::ranges::stable_sort(expectedEntries, {}, &SSpriteSortEntry::Key);
+
+    TSpriteSortEntries scratch;
+    SortSpriteEntries(entries, scratch, maxThreadCount);
+
+    auto isMatching = entries.size() == expectedEntries.size() &&
+        std::ranges::equal(entries, expectedEntries, [](const auto& left, const auto& right) {
+            return left.Key == right.Key && left.Index == right.Index;
+        });
+    Check(isMatching, fmt::format("SortSpriteEntries matches std::stable_sort for {} entries on up to {} threads", entryCount, maxThreadCount));
+}
+
+auto static CheckSortKeyOrdering() -> void {
+
+    Check(MakeSpriteSortKey(0, -100.0f) < MakeSpriteSortKey(0, -1.0f), "more negative y sorts first");
+    Check(MakeSpriteSortKey(0, -1.0f) < MakeSpriteSortKey(0, 0.0f), "negative y sorts before zero");
+    Check(MakeSpriteSortKey(0, -0.0f) <= MakeSpriteSortKey(0, 0.0f), "negative zero does not sort after zero");
+    Check(MakeSpriteSortKey(0, 0.0f) < MakeSpriteSortKey(0, 1.0f), "zero sorts before positive y");
+    Check(MakeSpriteSortKey(0, 1.0f) < MakeSpriteSortKey(0, 100.0f), "larger positive y sorts later");
+    Check(MakeSpriteSortKey(0, 1.0e9f) < MakeSpriteSortKey(1, -1.0e9f), "layer takes precedence over y");
+    Check(MakeSpriteSortKey(1, 0.0f) < MakeSpriteSortKey(2, 0.0f), "higher layers sort later");
+}
+
+int32_t main() {
+
+    CheckSortKeyOrdering();
+
+    // thread counts are forced, so the threaded path runs even on a single core machine
+    for (auto maxThreadCount : { 1u, 2u, 4u, g_spriteSortAllHardwareThreads }) {
+        for (auto entryCount : {
+            size_t{0},
+            size_t{1},
+            size_t{2},
+            g_minEntriesPerSortThread - 1,
+            g_minEntriesPerSortThread * 2 + 1,
+            g_minEntriesPerSortThread * 4 + 1,
+            size_t{100000} }) {
+            CheckSortMatchesStableSort(entryCount, maxThreadCount);
+        }
+    }
+
+    // the worker pool is reused, a second large sort must not see state of the first one
+    CheckSortMatchesStableSort(100000, 4);
+    CheckSortMatchesStableSort(100000, 2);
+
+    return FinishChecks("SpriteSortTests");
+}
\ No newline at end of file
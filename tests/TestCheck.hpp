@@ -0,0 +1,30 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+#include <cstdint>
+#include <string_view>
+
+// Minimal check harness for the test executables, a failed check is logged and counted
+// and FinishChecks turns the count into the exit code ctest looks at.
+
+inline int32_t g_failedCheckCount = 0;
+
+inline auto Check(bool condition, std::string_view description) -> void {
+
+    if (!condition) {
+        spdlog::error("Check failed: {}", description);
+        g_failedCheckCount++;
+    }
+}
+
+inline auto FinishChecks(std::string_view testName) -> int32_t {
+
+    if (g_failedCheckCount > 0) {
+        spdlog::error("{} {} checks failed", testName, g_failedCheckCount);
+        return 1;
+    }
+
+    spdlog::info("{} All checks passed", testName);
+    return 0;
+}
\ No newline at end of file